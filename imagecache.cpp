@@ -0,0 +1,59 @@
+#include "imagecache.h"
+#include <QMutexLocker>
+#include <QSettings>
+#include <QDebug>
+#include <limits>
+
+const char *const ImageCache::kBudgetKey = "imageCache/budgetMB";
+
+static const int kDefaultBudgetMB = 256;
+
+ImageCache::ImageCache()
+{
+    QSettings settings("MyCompany", "KnowledgeReview");
+    const int budgetMB = settings.value(kBudgetKey, kDefaultBudgetMB).toInt();
+    setBudget(qint64(qMax(budgetMB, 0)) * 1024 * 1024);
+}
+
+QString ImageCache::key(const QString &path, const QSize &decodeSize)
+{
+    return QString("%1@%2x%3").arg(path).arg(decodeSize.width()).arg(decodeSize.height());
+}
+
+QImage ImageCache::find(const QString &path, const QSize &decodeSize) const
+{
+    QMutexLocker locker(&m_mutex);
+    const QImage *image = m_images.object(key(path, decodeSize));
+    return image ? *image : QImage();
+}
+
+void ImageCache::insert(const QString &path, const QSize &decodeSize, const QImage &image)
+{
+    if (image.isNull()) {
+        return;
+    }
+
+    // 比整个预算还大的图片 QCache 会直接丢弃
+    const int cost = int(qMax<qint64>(1, image.sizeInBytes() / 1024));
+    QMutexLocker locker(&m_mutex);
+    m_images.insert(key(path, decodeSize), new QImage(image), cost);
+}
+
+void ImageCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_images.clear();
+}
+
+qint64 ImageCache::budget() const
+{
+    QMutexLocker locker(&m_mutex);
+    return qint64(m_images.maxCost()) * 1024;
+}
+
+void ImageCache::setBudget(qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_images.setMaxCost(int(qMin<qint64>(bytes / 1024, std::numeric_limits<int>::max())));
+    qDebug() << "Image cache budget:" << bytes / (1024 * 1024) << "MB";
+}
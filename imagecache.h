@@ -0,0 +1,35 @@
+#ifndef IMAGECACHE_H
+#define IMAGECACHE_H
+
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+#include <QSize>
+#include <QString>
+
+// 解码后图片的 LRU 缓存，按 (文件路径, 解码尺寸) 查找，总字节数不超过预算。
+// 主窗口、图片查看器和解码线程共用一份，所有操作都加锁。
+// 预算保存在注册表 imageCache/budgetMB，默认 256 MB
+class ImageCache
+{
+public:
+    static const char *const kBudgetKey;
+
+    ImageCache();
+
+    // decodeSize 为空表示按原始尺寸解码；未命中时返回空图片
+    QImage find(const QString &path, const QSize &decodeSize = QSize()) const;
+    void insert(const QString &path, const QSize &decodeSize, const QImage &image);
+    void clear();
+
+    qint64 budget() const; // 字节
+    void setBudget(qint64 bytes);
+
+private:
+    mutable QMutex m_mutex;
+    mutable QCache<QString, QImage> m_images; // 查找会更新 LRU 顺序；开销以 KB 计
+
+    static QString key(const QString &path, const QSize &decodeSize);
+};
+
+#endif // IMAGECACHE_H
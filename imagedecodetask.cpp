@@ -0,0 +1,123 @@
+#include "imagedecodetask.h"
+#include "imagecache.h"
+#include "imageloader.h"
+#include <QFileInfo>
+#include <QMetaObject>
+
+// 原图按长边向上取整到这个步长解码，步长内的缩放共用一份缓存
+static const int kDecodeBucket = 512;
+
+// 目标尺寸所在的解码档位：长边取整到步长，不超过原图
+static QSize decodeBucket(const QSize &originalSize, const QSize &scaledSize)
+{
+    const int longest = qMax(scaledSize.width(), scaledSize.height());
+    const int bucket = (longest + kDecodeBucket - 1) / kDecodeBucket * kDecodeBucket;
+    if (bucket >= qMax(originalSize.width(), originalSize.height())) {
+        return originalSize;
+    }
+    return originalSize.scaled(bucket, bucket, Qt::KeepAspectRatio).expandedTo(QSize(1, 1));
+}
+
+ImageDecodeTask::ImageDecodeTask(const QString &imagePath, const QSize &boundingSize, double zoomFactor,
+                                 const ImageThumbnails &thumbnails, ImageCache *cache, int generation,
+                                 const std::atomic<int> *latestGeneration)
+    : m_imagePath(imagePath)
+    , m_boundingSize(boundingSize)
+    , m_zoomFactor(zoomFactor)
+    , m_thumbnails(thumbnails)
+    , m_cache(cache)
+    , m_generation(generation)
+    , m_latestGeneration(latestGeneration)
+{
+}
+
+void ImageDecodeTask::setResultHandler(QObject *context, const ResultHandler &handler)
+{
+    m_context = context;
+    m_handler = handler;
+}
+
+void ImageDecodeTask::setFullResolution(bool fullResolution)
+{
+    m_fullResolution = fullResolution;
+}
+
+bool ImageDecodeTask::isCancelled() const
+{
+    return m_latestGeneration->load(std::memory_order_relaxed) != m_generation;
+}
+
+void ImageDecodeTask::run()
+{
+    if (isCancelled()) {
+        return; // 排队期间选中已经移走
+    }
+
+    QString errorMessage;
+    const QImage image = decode(&errorMessage);
+    if (isCancelled()) {
+        return;
+    }
+
+    const ResultHandler handler = m_handler;
+    const int generation = m_generation;
+    QMetaObject::invokeMethod(m_context, [handler, generation, image, errorMessage]() {
+        handler(generation, image, errorMessage);
+    }, Qt::QueuedConnection);
+}
+
+QImage ImageDecodeTask::decode(QString *errorMessage) const
+{
+    QFileInfo fileInfo(m_imagePath);
+    if (!fileInfo.exists() || !fileInfo.isFile()) {
+        *errorMessage = "图片文件不存在";
+        return QImage();
+    }
+
+    if (m_fullResolution) {
+        QImage image = m_cache->find(m_imagePath);
+        if (image.isNull()) {
+            image = ImageLoader::load(m_imagePath, QSize(), errorMessage);
+            if (image.isNull()) {
+                return image;
+            }
+            const QImage::Format format = image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                                  : QImage::Format_RGB32;
+            if (image.format() != format) {
+                image = image.convertToFormat(format);
+            }
+            m_cache->insert(m_imagePath, QSize(), image);
+        }
+        return image;
+    }
+
+    // 只读文件头取得原图尺寸，按显示区域和缩放因子确定目标尺寸
+    const QSize originalSize = ImageLoader::imageSize(m_imagePath);
+    const QSize scaledSize = ImageLoader::targetSize(originalSize, m_boundingSize, m_zoomFactor);
+    if (!scaledSize.isValid()) {
+        // 文件头读不出尺寸，按原始尺寸解码
+        QImage image = ImageLoader::load(m_imagePath, QSize(), errorMessage);
+        return image.isNull() ? image : image.scaled(image.size() * m_zoomFactor, Qt::KeepAspectRatio,
+                                                     Qt::SmoothTransformation);
+    }
+
+    // 缩略图按原尺寸解码并缓存，缩放时多半还是同一档，只需在内存里缩小。
+    // 没有合适的缩略图时（放大到超过最大一档，或图片不在存储目录），原图由读取器
+    // 直接解码到目标尺寸所在的档位，以档位尺寸为键缓存：同一档内的缩放不再读文件，
+    // 也不会为此解码整张原图
+    const QString sourcePath = m_thumbnails.pathFor(m_imagePath, qMax(scaledSize.width(), scaledSize.height()));
+    const QSize decodeSize = sourcePath == m_imagePath ? decodeBucket(originalSize, scaledSize) : QSize();
+    QImage image = m_cache->find(sourcePath, decodeSize);
+    if (image.isNull()) {
+        image = ImageLoader::load(sourcePath, decodeSize, errorMessage);
+        if (image.isNull()) {
+            return image;
+        }
+        m_cache->insert(sourcePath, decodeSize, image);
+    }
+
+    if (image.size() == scaledSize || isCancelled()) {
+        return image;
+    }
+    return image.scaled(scaledSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+}
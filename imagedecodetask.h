@@ -0,0 +1,52 @@
+#ifndef IMAGEDECODETASK_H
+#define IMAGEDECODETASK_H
+
+#include <QRunnable>
+#include <QObject>
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <atomic>
+#include <functional>
+#include "imagethumbnails.h"
+
+class ImageCache;
+
+// 在线程池里为详情区解码并缩放图片，界面线程只把结果转成 QPixmap。
+// 与过滤任务一样带一个代数：latestGeneration 变化（选中了别的知识点）后，
+// 还没开始的任务直接退出，已解码的结果不再投递。
+// 解码出的图片放进共用的 ImageCache，缩放和回看同一张卡片时不再读文件
+class ImageDecodeTask : public QRunnable
+{
+public:
+    // image 为空时 errorMessage 说明原因，用于显示在图片区
+    typedef std::function<void(int generation, const QImage &image, const QString &errorMessage)> ResultHandler;
+
+    // 缩放因子 1.0 时适应 boundingSize，不放大小图
+    ImageDecodeTask(const QString &imagePath, const QSize &boundingSize, double zoomFactor,
+                    const ImageThumbnails &thumbnails, ImageCache *cache, int generation,
+                    const std::atomic<int> *latestGeneration);
+
+    void setResultHandler(QObject *context, const ResultHandler &handler);
+    // 图片查看器用：不找缩略图，按原始尺寸解码原图，并转换成分块绘制最快的格式
+    void setFullResolution(bool fullResolution);
+
+    void run() override;
+
+private:
+    QString m_imagePath;
+    QSize m_boundingSize;
+    double m_zoomFactor;
+    ImageThumbnails m_thumbnails;
+    ImageCache *m_cache;
+    bool m_fullResolution = false;
+    int m_generation;
+    const std::atomic<int> *m_latestGeneration;
+    QObject *m_context = nullptr;
+    ResultHandler m_handler;
+
+    bool isCancelled() const;
+    QImage decode(QString *errorMessage) const;
+};
+
+#endif // IMAGEDECODETASK_H
@@ -0,0 +1,44 @@
+#include "imageloader.h"
+#include <QImageReader>
+#include <QDebug>
+
+QSize ImageLoader::imageSize(const QString &path)
+{
+    return QImageReader(path).size();
+}
+
+QSize ImageLoader::targetSize(const QSize &originalSize, const QSize &bounds, double zoomFactor)
+{
+    if (!originalSize.isValid()) {
+        return QSize();
+    }
+
+    QSize size = originalSize;
+    if (size.width() > bounds.width() || size.height() > bounds.height()) {
+        size.scale(bounds, Qt::KeepAspectRatio);
+    }
+    return (size * zoomFactor).expandedTo(QSize(1, 1));
+}
+
+QImage ImageLoader::load(const QString &path, const QSize &size, QString *errorMessage)
+{
+    QImageReader reader(path);
+    if (size.isValid()) {
+        // 读取器只接受确切的尺寸，先按原图比例算好
+        QSize scaledSize = reader.size();
+        if (scaledSize.isValid()) {
+            scaledSize.scale(size, Qt::KeepAspectRatio);
+            reader.setScaledSize(scaledSize.expandedTo(QSize(1, 1)));
+        }
+        reader.setQuality(100); // JPEG 读取器按质量选择缩放算法，最高质量时平滑缩放
+    }
+
+    QImage image = reader.read();
+    if (image.isNull()) {
+        qDebug() << "Failed to decode image:" << path << reader.errorString();
+        if (errorMessage) {
+            *errorMessage = "图片加载失败";
+        }
+    }
+    return image;
+}
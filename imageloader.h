@@ -0,0 +1,23 @@
+#ifndef IMAGELOADER_H
+#define IMAGELOADER_H
+
+#include <QImage>
+#include <QSize>
+#include <QString>
+
+// 按显示尺寸解码图片：先只读文件头取得原图尺寸，再让 QImageReader
+// 直接解码到目标尺寸。JPEG 在解码时就按 1/2、1/4、1/8 缩小，
+// 不会先生成整张原图；其他格式由读取器解码后缩小，结果相同
+class ImageLoader
+{
+public:
+    static QSize imageSize(const QString &path); // 只读文件头，读不出时返回空尺寸
+
+    // 原图适应 bounds（不放大小图）后乘以 zoomFactor
+    static QSize targetSize(const QSize &originalSize, const QSize &bounds, double zoomFactor = 1.0);
+
+    // 解码到 size（保持比例）；size 为空时按原始尺寸解码。失败时返回空图片
+    static QImage load(const QString &path, const QSize &size = QSize(), QString *errorMessage = nullptr);
+};
+
+#endif // IMAGELOADER_H
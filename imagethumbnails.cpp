@@ -0,0 +1,138 @@
+#include "imagethumbnails.h"
+#include "imageloader.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QPainter>
+#include <QSaveFile>
+#include <QDebug>
+
+// JPEG 解码比 PNG 快，缩略图不需要无损
+static const int kThumbnailQuality = 90;
+
+ImageThumbnails::ImageThumbnails(const QString &directory)
+{
+    setDirectory(directory);
+}
+
+void ImageThumbnails::setDirectory(const QString &directory)
+{
+    m_directory = directory.isEmpty() ? QString() : QDir(directory).absolutePath();
+}
+
+const QVector<int> &ImageThumbnails::sizes()
+{
+    static const QVector<int> kSizes = {256, 512, 1024, 2048};
+    return kSizes;
+}
+
+QString ImageThumbnails::thumbnailPath(const QString &imagePath, int size)
+{
+    return QString("%1.thumb%2.jpg").arg(imagePath).arg(size);
+}
+
+bool ImageThumbnails::isManaged(const QString &imagePath) const
+{
+    return !m_directory.isEmpty() && QFileInfo(imagePath).absolutePath() == m_directory;
+}
+
+bool ImageThumbnails::generate(const QString &imagePath) const
+{
+    if (!isManaged(imagePath)) {
+        return false;
+    }
+
+    // 最大一档以上的部分不需要：JPEG 直接解码到最大一档，不生成整张原图
+    const int largest = sizes().last();
+    const QSize originalSize = ImageLoader::imageSize(imagePath);
+    const bool oversized = qMax(originalSize.width(), originalSize.height()) > largest;
+    QImage image = ImageLoader::load(imagePath, oversized ? QSize(largest, largest) : QSize());
+    if (image.isNull()) {
+        return false;
+    }
+
+    // JPEG 没有透明通道，透明部分铺成白色
+    if (image.hasAlphaChannel()) {
+        QImage opaque(image.size(), QImage::Format_RGB32);
+        opaque.fill(Qt::white);
+        QPainter painter(&opaque);
+        painter.drawImage(0, 0, image);
+        painter.end();
+        image = opaque;
+    }
+
+    // 从大到小逐档缩小，每一档都从上一档缩得到；是否需要某一档按原图尺寸判断
+    const int longest = oversized ? qMax(originalSize.width(), originalSize.height())
+                                  : qMax(image.width(), image.height());
+    const QVector<int> &thumbnailSizes = sizes();
+    bool ok = true;
+    for (int i = thumbnailSizes.size() - 1; i >= 0; --i) {
+        const int size = thumbnailSizes.at(i);
+        if (size >= longest) {
+            continue; // 原图已经够小
+        }
+
+        // 先写临时文件再改名：解码线程可能同时补建同一张图的缩略图
+        image = image.scaled(size, size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        QSaveFile file(thumbnailPath(imagePath, size));
+        if (!file.open(QIODevice::WriteOnly)
+            || !image.save(&file, "JPG", kThumbnailQuality)
+            || !file.commit()) {
+            qDebug() << "Failed to save thumbnail:" << thumbnailPath(imagePath, size);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+QString ImageThumbnails::pathFor(const QString &imagePath, int longestSide) const
+{
+    const QVector<int> &thumbnailSizes = sizes();
+    int size = -1;
+    for (int candidate : thumbnailSizes) {
+        if (candidate >= longestSide) {
+            size = candidate;
+            break;
+        }
+    }
+    if (size < 0 || !isManaged(imagePath)) {
+        return imagePath;
+    }
+
+    const QString path = thumbnailPath(imagePath, size);
+    if (QFileInfo::exists(path)) {
+        return path;
+    }
+
+    // 缺少缩略图：原图不比这一档大时本来就不生成，否则补建
+    const QSize original = ImageLoader::imageSize(imagePath);
+    if (!original.isValid() || qMax(original.width(), original.height()) <= size) {
+        return imagePath;
+    }
+
+    qDebug() << "Rebuilding thumbnails for" << imagePath;
+    generate(imagePath);
+    return QFileInfo::exists(path) ? path : imagePath;
+}
+
+void ImageThumbnails::remove(const QString &imagePath)
+{
+    for (int size : sizes()) {
+        QFile::remove(thumbnailPath(imagePath, size));
+    }
+}
+
+ImageThumbnailTask::ImageThumbnailTask(const ImageThumbnails &thumbnails, const QString &imagePath)
+    : m_thumbnails(thumbnails)
+    , m_imagePath(imagePath)
+{
+}
+
+void ImageThumbnailTask::run()
+{
+    // 排队期间原图可能已随知识点一起删除
+    if (QFileInfo::exists(m_imagePath)) {
+        m_thumbnails.generate(m_imagePath);
+    }
+}
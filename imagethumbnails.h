@@ -0,0 +1,54 @@
+#ifndef IMAGETHUMBNAILS_H
+#define IMAGETHUMBNAILS_H
+
+#include <QString>
+#include <QSize>
+#include <QVector>
+#include <QRunnable>
+
+// 图片缩略图：按长边分档保存在原图旁边，文件名为 <原图名>.thumb<长边>.jpg，
+// 比原图小的档位才生成。只为图片存储目录里的原图生成缩略图，
+// 其他位置的图片直接使用原图。存储目录里旧的图片在第一次显示时补建。
+// 只读取文件，不使用 QPixmap，可以在工作线程里调用
+class ImageThumbnails
+{
+public:
+    explicit ImageThumbnails(const QString &directory = QString());
+
+    void setDirectory(const QString &directory);
+
+    // 缩略图的长边档位，从小到大
+    static const QVector<int> &sizes();
+    static QString thumbnailPath(const QString &imagePath, int size);
+
+    // 解码一次原图，生成所有档位；复制到存储目录后调用
+    bool generate(const QString &imagePath) const;
+
+    // 长边不小于 longestSide 的最小缩略图；缺少时补建，
+    // 没有足够大的档位或无法生成时返回原图路径
+    QString pathFor(const QString &imagePath, int longestSide) const;
+
+    // 删除原图的全部缩略图
+    static void remove(const QString &imagePath);
+
+private:
+    QString m_directory;
+
+    bool isManaged(const QString &imagePath) const;
+};
+
+// 在线程池里为刚复制进存储目录的原图生成缩略图，不占用GUI线程。
+// 生成完成前显示时 pathFor 会自己补建，两边都通过 QSaveFile 整体替换文件
+class ImageThumbnailTask : public QRunnable
+{
+public:
+    ImageThumbnailTask(const ImageThumbnails &thumbnails, const QString &imagePath);
+
+    void run() override;
+
+private:
+    ImageThumbnails m_thumbnails;
+    QString m_imagePath;
+};
+
+#endif // IMAGETHUMBNAILS_H
@@ -1,37 +1,29 @@
 #include "imageviewerdialog.h"
-#include <QLabel>
-#include <QScrollArea>
+#include "imagedecodetask.h"
+#include "tiledimageview.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QToolBar>
 #include <QAction>
-#include <QScrollBar>
 #include <QWheelEvent>
 #include <QMouseEvent>
 #include <QKeyEvent>
 #include <QFileInfo>
+#include <QThreadPool>
 #include <QDebug>
 
+// 查看器的原图缓存：够放下最近打开的一两张大图
+static const qint64 kOriginalCacheBudget = 192LL * 1024 * 1024;
+
 ImageViewerDialog::ImageViewerDialog(QWidget *parent)
     : QDialog(parent)
-    , m_scaleFactor(1.0)
 {
     setWindowTitle("图片查看器");
     resize(800, 600);
+    m_originalCache.setBudget(kOriginalCacheBudget);
 
-    // 创建滚动区域
-    m_scrollArea = new QScrollArea(this);
-    m_scrollArea->setBackgroundRole(QPalette::Dark);
-    m_scrollArea->setAlignment(Qt::AlignCenter);
-
-    // 创建图片标签
-    m_imageLabel = new QLabel();
-    m_imageLabel->setBackgroundRole(QPalette::Base);
-    m_imageLabel->setSizePolicy(QSizePolicy::Ignored, QSizePolicy::Ignored);
-    m_imageLabel->setScaledContents(false);
-    m_imageLabel->setAlignment(Qt::AlignCenter);
-
-    m_scrollArea->setWidget(m_imageLabel);
+    // 创建分块显示的图片视图（自带滚动条）
+    m_imageView = new TiledImageView(this);
 
     // 创建工具栏
     QToolBar *toolBar = new QToolBar(this);
@@ -54,41 +46,54 @@ ImageViewerDialog::ImageViewerDialog(QWidget *parent)
     // 布局
     QVBoxLayout *mainLayout = new QVBoxLayout(this);
     mainLayout->addWidget(toolBar);
-    mainLayout->addWidget(m_scrollArea);
+    mainLayout->addWidget(m_imageView);
 
     setLayout(mainLayout);
 }
 
+void ImageViewerDialog::setImagePool(QThreadPool *pool)
+{
+    m_imagePool = pool;
+}
+
 void ImageViewerDialog::setImage(const QPixmap *pixmap)
 {
     if (pixmap && !pixmap->isNull()) {
-        m_originalPixmap = *pixmap;  // 解引用指针获取对象
-        m_imageLabel->setPixmap(m_originalPixmap);
-        resetZoom();
+        m_imageView->setImage(pixmap->toImage());  // 解引用指针获取对象
     }
 }
 
 void ImageViewerDialog::setImage(const QPixmap &pixmap)
 {
     if (!pixmap.isNull()) {
-        m_originalPixmap = pixmap;
-        m_imageLabel->setPixmap(m_originalPixmap);
-        resetZoom();
+        m_imageView->setImage(pixmap.toImage());
     }
 }
 void ImageViewerDialog::setImage(const QString &imagePath)
 {
-    if (!imagePath.isEmpty()) {
-        QPixmap pixmap(imagePath);
-        if (!pixmap.isNull()) {
-            m_originalPixmap = pixmap;
-            m_imageLabel->setPixmap(m_originalPixmap);
-            resetZoom();
+    const int generation = ++m_imageGeneration;
+    m_imageView->setImage(QImage()); // 不再显示上一张图片
+    if (imagePath.isEmpty() || !m_imagePool) {
+        return;
+    }
+
+    // 原图在线程池里按原始尺寸解码，再次打开同一张图时从查看器自己的缓存取
+    ImageDecodeTask *task = new ImageDecodeTask(imagePath, QSize(), 1.0, ImageThumbnails(), &m_originalCache,
+                                                generation, &m_imageGeneration);
+    task->setFullResolution(true);
+    task->setResultHandler(this, [this, imagePath](int resultGeneration, const QImage &image,
+                                                   const QString &errorMessage) {
+        if (resultGeneration != m_imageGeneration) {
+            return;
+        }
+        if (!image.isNull()) {
+            m_imageView->setImage(image); // 缩放比例回到 1.0
         } else {
             // 可选：处理加载失败的情况
-            qWarning() << "Failed to load image:" << imagePath;
+            qWarning() << "Failed to load image:" << imagePath << errorMessage;
         }
-    }
+    });
+    m_imagePool->start(task);
 }
 
 void ImageViewerDialog::zoomIn()
@@ -103,39 +108,20 @@ void ImageViewerDialog::zoomOut()
 
 void ImageViewerDialog::resetZoom()
 {
-    m_scaleFactor = 1.0;
-    m_imageLabel->setPixmap(m_originalPixmap);
-    m_imageLabel->adjustSize();
+    m_imageView->setScale(1.0);
 }
 
 void ImageViewerDialog::fitToWindow()
 {
-    if (m_originalPixmap.isNull()) return;
+    if (m_imageView->imageSize().isEmpty()) return;
 
-    QSize labelSize = m_scrollArea->size();
-    QSize pixmapSize = m_originalPixmap.size();
-
-    double scale = qMin(
-        double(labelSize.width()) / pixmapSize.width(),
-        double(labelSize.height()) / pixmapSize.height()
-        );
-
-    scaleImage(scale / m_scaleFactor);
+    m_imageView->setScale(m_imageView->fitScale());
 }
 
 void ImageViewerDialog::scaleImage(double factor)
 {
-    m_scaleFactor *= factor;
-
-    QSize newSize = m_originalPixmap.size() * m_scaleFactor;
-    QPixmap scaledPixmap = m_originalPixmap.scaled(
-        newSize,
-        Qt::KeepAspectRatio,
-        Qt::SmoothTransformation
-        );
-
-    m_imageLabel->setPixmap(scaledPixmap);
-    m_imageLabel->adjustSize();
+    // 视图只重绘可见图块，不生成整张缩放后的图片
+    m_imageView->setScale(m_imageView->scale() * factor);
 }
 
 void ImageViewerDialog::wheelEvent(QWheelEvent *event)
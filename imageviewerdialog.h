@@ -3,10 +3,11 @@
 
 #include <QDialog>
 #include <QPixmap>
-#include <QScrollBar>
+#include <atomic>
+#include "imagecache.h"
 
-class QLabel;
-class QScrollArea;
+class QThreadPool;
+class TiledImageView;
 
 class ImageViewerDialog : public QDialog
 {
@@ -14,7 +15,8 @@ class ImageViewerDialog : public QDialog
 
 public:
     explicit ImageViewerDialog(QWidget *parent = nullptr);
-    void setImage(const QString &imagePath);        // 文件路径版本
+    void setImagePool(QThreadPool *pool); // 解码原图用的线程池，与主窗口的图片解码共用
+    void setImage(const QString &imagePath);        // 文件路径版本，在线程池里解码
     void setImage(const QPixmap *pixmap);           // 指针版本
     void setImage(const QPixmap &pixmap);           // 引用版本
 
@@ -32,12 +34,12 @@ private slots:
 
 private:
     void scaleImage(double factor);
-    void adjustScrollBar(QScrollBar *scrollBar, double factor);
 
-    QLabel *m_imageLabel;
-    QScrollArea *m_scrollArea;
-    QPixmap m_originalPixmap;
-    double m_scaleFactor;
+    TiledImageView *m_imageView; // 只绘制可见图块，缩放不重采样整张图片
+    QThreadPool *m_imagePool = nullptr;
+    // 原图很大，单独计算预算，不挤掉主窗口详情区的解码结果
+    ImageCache m_originalCache;
+    std::atomic<int> m_imageGeneration{0}; // 换图时加一，丢弃上一张还在解码的原图
 };
 
 #endif // IMAGEVIEWERDIALOG_H
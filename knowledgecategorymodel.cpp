@@ -0,0 +1,83 @@
+#include "knowledgecategorymodel.h"
+#include "knowledgepointstore.h"
+#include <algorithm>
+
+KnowledgeCategoryModel::KnowledgeCategoryModel(KnowledgePointStore *store, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_store(store)
+    , m_categories(store->categoryCounts().keys())
+{
+    connect(store, &KnowledgePointStore::categoryAdded, this, &KnowledgeCategoryModel::addCategory);
+    connect(store, &KnowledgePointStore::categoryRemoved, this, &KnowledgeCategoryModel::removeCategory);
+    connect(store, &KnowledgePointStore::categoriesReset, this, &KnowledgeCategoryModel::resetCategories);
+}
+
+int KnowledgeCategoryModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_categories.size() + 1;
+}
+
+QVariant KnowledgeCategoryModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() > m_categories.size()) {
+        return QVariant();
+    }
+
+    // 第 0 行不过滤，数据为空字符串，与旧版 addItem("全部分类", "") 一致
+    if (index.row() == 0) {
+        if (role == Qt::DisplayRole) {
+            return QString("全部分类");
+        }
+        if (role == Qt::UserRole) {
+            return QString();
+        }
+        return QVariant();
+    }
+
+    const QString &category = m_categories.at(index.row() - 1);
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::UserRole:
+        return category;
+    case Qt::ToolTipRole:
+        return QString("%1 个知识点").arg(m_store->categoryCounts().value(category));
+    default:
+        return QVariant();
+    }
+}
+
+void KnowledgeCategoryModel::addCategory(const QString &category)
+{
+    auto it = std::lower_bound(m_categories.begin(), m_categories.end(), category);
+    if (it != m_categories.end() && *it == category) {
+        return;
+    }
+
+    const int row = int(it - m_categories.begin()) + 1;
+    beginInsertRows(QModelIndex(), row, row);
+    m_categories.insert(row - 1, category);
+    endInsertRows();
+}
+
+void KnowledgeCategoryModel::removeCategory(const QString &category)
+{
+    auto it = std::lower_bound(m_categories.begin(), m_categories.end(), category);
+    if (it == m_categories.end() || *it != category) {
+        return;
+    }
+
+    const int row = int(it - m_categories.begin()) + 1;
+    beginRemoveRows(QModelIndex(), row, row);
+    m_categories.removeAt(row - 1);
+    endRemoveRows();
+}
+
+void KnowledgeCategoryModel::resetCategories()
+{
+    beginResetModel();
+    m_categories = m_store->categoryCounts().keys();
+    endResetModel();
+}
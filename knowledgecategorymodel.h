@@ -0,0 +1,31 @@
+#ifndef KNOWLEDGECATEGORYMODEL_H
+#define KNOWLEDGECATEGORYMODEL_H
+
+#include <QAbstractListModel>
+#include <QStringList>
+
+class KnowledgePointStore;
+
+// 分类过滤下拉框的模型：第 0 行是“全部分类”，其余行按名称排序。
+// 跟随存储的分类索引增量插入、删除行，不在每次刷新时重建
+class KnowledgeCategoryModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit KnowledgeCategoryModel(KnowledgePointStore *store, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private slots:
+    void addCategory(const QString &category);
+    void removeCategory(const QString &category);
+    void resetCategories();
+
+private:
+    KnowledgePointStore *m_store;
+    QStringList m_categories; // 已排序，不含“全部分类”
+};
+
+#endif // KNOWLEDGECATEGORYMODEL_H
@@ -6,11 +6,79 @@
 #include <QFile>
 #include <QDir>
 #include <QStandardPaths>
+#include <QtAlgorithms>
+#include <QThread>
+#include <QThreadStorage>
+#include <utility>
+
+// 当前数据库结构版本，保存在 PRAGMA user_version 中
+// 1: 日期列为 ISO 文本  2: 日期列为儒略日整数并建立索引  3: FTS5 全文索引
+// 4: meta 表记录数据代数（每次提交加一，用于判断快照是否过期）
+// 5: 全文索引的更新触发器只在文本真正变化时重建该行的索引
+static const int kSchemaVersion = 5;
+
+// 日期以儒略日整数保存，便于索引范围扫描；无效日期保存为 NULL
+static QVariant dateToValue(const QDate &date)
+{
+    return date.isValid() ? QVariant(date.toJulianDay()) : QVariant();
+}
+
+static QDate valueToDate(const QVariant &value)
+{
+    return value.isNull() ? QDate() : QDate::fromJulianDay(value.toLongLong());
+}
+
+static qint64 todayDayNumber()
+{
+    return QDate::currentDate().toJulianDay();
+}
+
+static const char *const kCreatePointsTable =
+    "CREATE TABLE IF NOT EXISTS %1 ("
+    "id INTEGER PRIMARY KEY AUTOINCREMENT,"
+    "title TEXT NOT NULL,"
+    "content TEXT,"
+    "image_path TEXT,"
+    "category TEXT,"
+    "difficulty INTEGER DEFAULT 1,"
+    "status INTEGER DEFAULT 0,"
+    "mastery_level INTEGER DEFAULT 0,"
+    "created_date INTEGER,"
+    "last_reviewed INTEGER,"
+    "next_review INTEGER,"
+    "review_count INTEGER DEFAULT 0,"
+    "tags TEXT"
+    ")";
+
+// 查询知识点时固定的列顺序，readPoint() 按位置读取
+#define POINT_COLUMNS \
+    "id, title, content, image_path, category, status, mastery_level, " \
+    "created_date, last_reviewed, next_review, review_count"
+
+// 与 POINT_COLUMNS 位置相同，只是不读取长文本，readPoint() 可以直接使用
+#define POINT_SUMMARY_COLUMNS \
+    "id, title, NULL, NULL, category, status, mastery_level, " \
+    "created_date, last_reviewed, next_review, review_count"
+
+enum PointColumn {
+    COL_ID,
+    COL_TITLE,
+    COL_CONTENT,
+    COL_IMAGE_PATH,
+    COL_CATEGORY,
+    COL_STATUS,
+    COL_MASTERY_LEVEL,
+    COL_CREATED_DATE,
+    COL_LAST_REVIEWED,
+    COL_NEXT_REVIEW,
+    COL_REVIEW_COUNT
+};
 
 // 构造函数 - 注意类名大小写
-KnowledgeDatabaseManager::KnowledgeDatabaseManager(QObject *parent)
+KnowledgeDatabaseManager::KnowledgeDatabaseManager(QObject *parent, const QString &connectionName)
     : QObject(parent)
-    , database(QSqlDatabase::addDatabase("QSQLITE"))
+    , database(connectionName.isEmpty() ? QSqlDatabase::addDatabase("QSQLITE")
+                                        : QSqlDatabase::addDatabase("QSQLITE", connectionName))
 {
     // 初始化数据库路径
     QString appDataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
@@ -23,9 +91,16 @@ KnowledgeDatabaseManager::KnowledgeDatabaseManager(QObject *parent)
 
 KnowledgeDatabaseManager::~KnowledgeDatabaseManager()
 {
+    qDeleteAll(statementCache);
+    statementCache.clear();
     if (database.isOpen()) {
         database.close();
     }
+
+    // 释放连接对象后才能移除连接
+    QString connectionName = database.connectionName();
+    database = QSqlDatabase();
+    QSqlDatabase::removeDatabase(connectionName);
 }
 
 bool KnowledgeDatabaseManager::initializeDatabase(const QString &dbPath)
@@ -41,41 +116,140 @@ bool KnowledgeDatabaseManager::initializeDatabase(const QString &dbPath)
         return false;
     }
 
+    if (!configureConnection()) {
+        database.close();
+        return false;
+    }
+
     return createTables();
 }
 
+bool KnowledgeDatabaseManager::openReadOnly(const QString &dbPath)
+{
+    databasePath = dbPath;
+    database.setDatabaseName(databasePath);
+    database.setConnectOptions("QSQLITE_OPEN_READONLY");
+
+    if (!database.open()) {
+        qDebug() << "无法以只读方式打开数据库:" << database.lastError().text();
+        return false;
+    }
+
+    // 不建表，全文索引是否可用由主连接是否建好了它决定
+    QSqlQuery query(database);
+    ftsAvailable = query.exec("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'knowledge_fts'")
+                   && query.next();
+    return true;
+}
+
+KnowledgeDatabaseManager *KnowledgeDatabaseManager::readOnlyConnection(const QString &dbPath)
+{
+    // QSqlDatabase 只能在创建它的线程里使用，每个线程各保存一个连接
+    static QThreadStorage<KnowledgeDatabaseManager *> connections;
+
+    if (!connections.hasLocalData()) {
+        const QString name = QString("knowledge_read_%1").arg(quintptr(QThread::currentThreadId()));
+        connections.setLocalData(new KnowledgeDatabaseManager(nullptr, name));
+    }
+
+    KnowledgeDatabaseManager *database = connections.localData();
+    if (database->isConnected() && database->path() == dbPath) {
+        return database;
+    }
+
+    // 数据库路径变了：预编译语句属于旧连接，先释放
+    qDeleteAll(database->statementCache);
+    database->statementCache.clear();
+    database->database.close();
+    return database->openReadOnly(dbPath) ? database : nullptr;
+}
+
 bool KnowledgeDatabaseManager::isConnected() const
 {
     return database.isOpen();
 }
 
+QString KnowledgeDatabaseManager::path() const
+{
+    return databasePath;
+}
+
+bool KnowledgeDatabaseManager::configureConnection()
+{
+    QSqlQuery query(database);
+
+    // WAL 模式：写入只追加到日志文件，读写互不阻塞
+    if (!query.exec("PRAGMA journal_mode = WAL") || !query.next()
+        || query.value(0).toString().compare("wal", Qt::CaseInsensitive) != 0) {
+        qDebug() << "无法启用 WAL 模式:" << query.lastError().text();
+        return false;
+    }
+
+    // WAL 下 NORMAL 同步级别不会损坏数据库，只在检查点时 fsync
+    const QStringList pragmas = {
+        "PRAGMA synchronous = NORMAL",
+        "PRAGMA cache_size = -16000",   // 约 16MB 页缓存
+        "PRAGMA temp_store = MEMORY",
+        "PRAGMA wal_autocheckpoint = 1000"
+    };
+    for (const QString &pragma : pragmas) {
+        if (!query.exec(pragma)) {
+            qDebug() << "设置数据库参数失败:" << pragma << query.lastError().text();
+            return false;
+        }
+    }
+
+    return true;
+}
+
 bool KnowledgeDatabaseManager::createTables()
 {
-    QSqlQuery query;
+    QSqlQuery query(database);
 
-    // 创建知识点表
-    QString createPointsTable =
-        "CREATE TABLE IF NOT EXISTS knowledge_points ("
-        "id INTEGER PRIMARY KEY AUTOINCREMENT,"
-        "title TEXT NOT NULL,"
-        "content TEXT,"
-        "image_path TEXT,"
-        "category TEXT,"
-        "difficulty INTEGER DEFAULT 1,"
-        "status INTEGER DEFAULT 0,"
-        "mastery_level INTEGER DEFAULT 0,"
-        "created_date TEXT,"
-        "last_reviewed TEXT,"
-        "next_review TEXT,"
-        "review_count INTEGER DEFAULT 0,"
-        "tags TEXT"
-        ")";
+    int version = 0;
+    if (query.exec("PRAGMA user_version") && query.next()) {
+        version = query.value(0).toInt();
+    }
+
+    // 元数据表最先创建，之后的每次提交都会更新数据代数
+    if (!query.exec("CREATE TABLE IF NOT EXISTS meta (key TEXT PRIMARY KEY, value INTEGER)")
+        || !query.exec("INSERT OR IGNORE INTO meta (key, value) VALUES ('generation', 0)")) {
+        qDebug() << "创建元数据表失败:" << query.lastError().text();
+        return false;
+    }
+
+    bool pointsTableExists = false;
+    if (query.exec("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'knowledge_points'")) {
+        pointsTableExists = query.next();
+    }
 
-    if (!query.exec(createPointsTable)) {
+    // 旧版本以文本保存日期，需要重建为整数列
+    if (pointsTableExists && version < 2 && !migrateDatesToDayNumbers()) {
+        return false;
+    }
+
+    // 创建知识点表
+    if (!query.exec(QString(kCreatePointsTable).arg("knowledge_points"))) {
         qDebug() << "创建知识点表失败:" << query.lastError().text();
         return false;
     }
 
+    // 复习队列、状态筛选和分类筛选都按下次复习日期排序
+    const QStringList createIndexes = {
+        "CREATE INDEX IF NOT EXISTS idx_points_next_review "
+        "ON knowledge_points (next_review)",
+        "CREATE INDEX IF NOT EXISTS idx_points_status_next_review "
+        "ON knowledge_points (status, next_review)",
+        "CREATE INDEX IF NOT EXISTS idx_points_category_next_review "
+        "ON knowledge_points (category, next_review)"
+    };
+    for (const QString &sql : createIndexes) {
+        if (!query.exec(sql)) {
+            qDebug() << "创建索引失败:" << query.lastError().text();
+            return false;
+        }
+    }
+
     // 创建复习历史表
     QString createHistoryTable =
         "CREATE TABLE IF NOT EXISTS review_history ("
@@ -92,40 +266,316 @@ bool KnowledgeDatabaseManager::createTables()
         return false;
     }
 
+    // 旧版本的更新触发器没有 WHEN 条件，删除后按新定义重建
+    if (version < 5 && !query.exec("DROP TRIGGER IF EXISTS knowledge_points_fts_update")) {
+        qDebug() << "删除旧全文索引触发器失败:" << query.lastError().text();
+    }
+
+    // 全文索引失败不影响使用，搜索退回 LIKE 扫描
+    ftsAvailable = createFullTextIndex();
+
+    if (!query.exec(QString("PRAGMA user_version = %1").arg(kSchemaVersion))) {
+        qDebug() << "更新数据库版本失败:" << query.lastError().text();
+        return false;
+    }
+
     qDebug() << "数据库表创建成功";
     return true;
 }
 
-QVector<KnowledgePoint> KnowledgeDatabaseManager::getAllPoints() const
+bool KnowledgeDatabaseManager::createFullTextIndex()
+{
+    QSqlQuery query(database);
+
+    bool exists = false;
+    if (query.exec("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = 'knowledge_fts'")) {
+        exists = query.next();
+    }
+
+    // 外部内容表：索引本身不重复保存正文。
+    // trigram 分词器按三个字符切分，中文不需要分词即可做子串匹配（SQLite 3.34+）
+    if (!query.exec("CREATE VIRTUAL TABLE IF NOT EXISTS knowledge_fts USING fts5("
+                    "title, content, tags, "
+                    "content = 'knowledge_points', content_rowid = 'id', "
+                    "tokenize = 'trigram')")) {
+        qDebug() << "全文索引不可用，搜索将使用 LIKE:" << query.lastError().text();
+        return false;
+    }
+
+    // 由触发器保持全文索引与知识点表同步；只改元数据的 UPDATE 即使写了标题列，
+    // 文本没变也不重建该行的索引
+    const QStringList triggers = {
+        "CREATE TRIGGER IF NOT EXISTS knowledge_points_fts_insert "
+        "AFTER INSERT ON knowledge_points BEGIN "
+        "INSERT INTO knowledge_fts (rowid, title, content, tags) "
+        "VALUES (new.id, new.title, new.content, new.tags); "
+        "END",
+        "CREATE TRIGGER IF NOT EXISTS knowledge_points_fts_delete "
+        "AFTER DELETE ON knowledge_points BEGIN "
+        "INSERT INTO knowledge_fts (knowledge_fts, rowid, title, content, tags) "
+        "VALUES ('delete', old.id, old.title, old.content, old.tags); "
+        "END",
+        "CREATE TRIGGER IF NOT EXISTS knowledge_points_fts_update "
+        "AFTER UPDATE OF title, content, tags ON knowledge_points "
+        "WHEN old.title IS NOT new.title OR old.content IS NOT new.content "
+        "OR old.tags IS NOT new.tags BEGIN "
+        "INSERT INTO knowledge_fts (knowledge_fts, rowid, title, content, tags) "
+        "VALUES ('delete', old.id, old.title, old.content, old.tags); "
+        "INSERT INTO knowledge_fts (rowid, title, content, tags) "
+        "VALUES (new.id, new.title, new.content, new.tags); "
+        "END"
+    };
+    for (const QString &sql : triggers) {
+        if (!query.exec(sql)) {
+            qDebug() << "创建全文索引触发器失败:" << query.lastError().text();
+            return false;
+        }
+    }
+
+    // 新建的索引需要从已有数据重建一次
+    if (!exists && !query.exec("INSERT INTO knowledge_fts (knowledge_fts) VALUES ('rebuild')")) {
+        qDebug() << "重建全文索引失败:" << query.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+bool KnowledgeDatabaseManager::migrateDatesToDayNumbers()
+{
+    qDebug() << "将日期列迁移为儒略日整数...";
+
+    // SQLite 无法修改列类型：建新表、复制数据、删除旧表、改名
+    const QStringList steps = {
+        QString(kCreatePointsTable).arg("knowledge_points_new"),
+        "INSERT INTO knowledge_points_new "
+        "(id, title, content, image_path, category, difficulty, status, mastery_level, "
+        "created_date, last_reviewed, next_review, review_count, tags) "
+        "SELECT id, title, content, image_path, category, difficulty, status, mastery_level, "
+        "CAST(julianday(created_date) + 0.5 AS INTEGER), "
+        "CAST(julianday(last_reviewed) + 0.5 AS INTEGER), "
+        "CAST(julianday(next_review) + 0.5 AS INTEGER), "
+        "review_count, tags FROM knowledge_points",
+        "DROP TABLE knowledge_points",
+        "ALTER TABLE knowledge_points_new RENAME TO knowledge_points"
+    };
+
+    if (!beginTransaction()) {
+        return false;
+    }
+
+    QSqlQuery query(database);
+    for (const QString &sql : steps) {
+        if (!query.exec(sql)) {
+            qDebug() << "日期迁移失败:" << query.lastError().text();
+            rollbackTransaction();
+            return false;
+        }
+    }
+
+    return commitTransaction();
+}
+
+bool KnowledgeDatabaseManager::beginTransaction()
+{
+    if (!database.transaction()) {
+        qDebug() << "开始事务失败:" << database.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool KnowledgeDatabaseManager::commitTransaction()
+{
+    // 数据代数与本次改动在同一事务中提交
+    QSqlQuery *query = cachedQuery("UPDATE meta SET value = value + 1 WHERE key = 'generation'");
+    if (!query || !query->exec()) {
+        qDebug() << "更新数据代数失败";
+        database.rollback();
+        return false;
+    }
+
+    if (!database.commit()) {
+        qDebug() << "提交事务失败:" << database.lastError().text();
+        database.rollback();
+        return false;
+    }
+    return true;
+}
+
+void KnowledgeDatabaseManager::rollbackTransaction()
+{
+    database.rollback();
+}
+
+bool KnowledgeDatabaseManager::setFullSync(bool full)
+{
+    QSqlQuery query(database);
+    if (!query.exec(full ? "PRAGMA synchronous = FULL" : "PRAGMA synchronous = NORMAL")) {
+        qDebug() << "设置同步级别失败:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+QSqlQuery *KnowledgeDatabaseManager::cachedQuery(const QString &sql) const
+{
+    QSqlQuery *query = statementCache.value(sql);
+    if (!query) {
+        query = new QSqlQuery(database);
+        query->setForwardOnly(true);
+        if (!query->prepare(sql)) {
+            qDebug() << "预编译语句失败:" << sql << query->lastError().text();
+            delete query;
+            return nullptr;
+        }
+        statementCache.insert(sql, query);
+    }
+    return query;
+}
+
+KnowledgePoint KnowledgeDatabaseManager::readPoint(const QSqlQuery &query)
+{
+    KnowledgePoint point;
+    point.id = query.value(COL_ID).toInt();
+    point.title = query.value(COL_TITLE).toString();
+    point.content = query.value(COL_CONTENT).toString();
+    point.imagePath = query.value(COL_IMAGE_PATH).toString();
+    point.category = query.value(COL_CATEGORY).toString();
+    point.status = static_cast<KnowledgeStatus>(query.value(COL_STATUS).toInt());
+    point.masteryLevel = query.value(COL_MASTERY_LEVEL).toInt();
+    point.createDate = valueToDate(query.value(COL_CREATED_DATE));
+    point.lastReviewDate = valueToDate(query.value(COL_LAST_REVIEWED));
+    point.nextReviewDate = valueToDate(query.value(COL_NEXT_REVIEW));
+    point.reviewCount = query.value(COL_REVIEW_COUNT).toInt();
+    point.reviewtureCount = 0;
+    return point;
+}
+
+// 按 POINT_COLUMNS 的顺序绑定全部字段
+void KnowledgeDatabaseManager::bindPoint(QSqlQuery *query, const KnowledgePoint &point)
+{
+    // ID 小于等于 0 时由数据库自动分配
+    query->bindValue(COL_ID, point.id > 0 ? QVariant(point.id) : QVariant());
+    query->bindValue(COL_TITLE, point.title);
+    query->bindValue(COL_CONTENT, point.content);
+    query->bindValue(COL_IMAGE_PATH, point.imagePath);
+    query->bindValue(COL_CATEGORY, point.category);
+    query->bindValue(COL_STATUS, static_cast<int>(point.status));
+    query->bindValue(COL_MASTERY_LEVEL, point.masteryLevel);
+    query->bindValue(COL_CREATED_DATE, dateToValue(point.createDate));
+    query->bindValue(COL_LAST_REVIEWED, dateToValue(point.lastReviewDate));
+    query->bindValue(COL_NEXT_REVIEW, dateToValue(point.nextReviewDate));
+    query->bindValue(COL_REVIEW_COUNT, point.reviewCount);
+}
+
+QVector<KnowledgePoint> KnowledgeDatabaseManager::fetchPoints(QSqlQuery *query) const
 {
     QVector<KnowledgePoint> points;
 
+    if (!query->exec()) {
+        qDebug() << "读取知识点失败:" << query->lastError().text();
+        return points;
+    }
+
+    while (query->next()) {
+        points.append(readPoint(*query));
+    }
+
+    // 释放读游标，避免长期占用 WAL 读快照
+    query->finish();
+    return points;
+}
+
+qint64 KnowledgeDatabaseManager::generation() const
+{
+    if (!database.isOpen()) {
+        return -1;
+    }
+
+    QSqlQuery *query = cachedQuery("SELECT value FROM meta WHERE key = 'generation'");
+    qint64 value = -1;
+    if (query && query->exec() && query->next()) {
+        value = query->value(0).toLongLong();
+    }
+    if (query) query->finish();
+    return value;
+}
+
+QVector<KnowledgePoint> KnowledgeDatabaseManager::getAllPoints() const
+{
     if (!database.isOpen()) {
         qDebug() << "数据库未连接";
-        return points;
+        return {};
+    }
+
+    QSqlQuery *query = cachedQuery(
+        "SELECT " POINT_COLUMNS " FROM knowledge_points ORDER BY next_review ASC");
+    return query ? fetchPoints(query) : QVector<KnowledgePoint>();
+}
+
+QVector<KnowledgePoint> KnowledgeDatabaseManager::getPointSummaries() const
+{
+    if (!database.isOpen()) {
+        qDebug() << "数据库未连接";
+        return {};
     }
 
-    QSqlQuery query("SELECT * FROM knowledge_points ORDER BY next_review ASC");
-    while (query.next()) {
-        KnowledgePoint point;
-        point.id = query.value("id").toInt();
-        point.title = query.value("title").toString();
-        point.content = query.value("content").toString();
-        point.imagePath = query.value("image_path").toString();
-        point.category = query.value("category").toString();
-        point.difficulty = query.value("difficulty").toInt();
-        point.status = query.value("status").toInt();
-        point.masteryLevel = query.value("mastery_level").toInt();
-        point.createdDate = query.value("created_date").toString();
-        point.lastReviewed = query.value("last_reviewed").toString();
-        point.nextReview = query.value("next_review").toString();
-        point.reviewCount = query.value("review_count").toInt();
-        point.tags = query.value("tags").toString();
+    QSqlQuery *query = cachedQuery(
+        "SELECT " POINT_SUMMARY_COLUMNS " FROM knowledge_points ORDER BY id ASC");
+    return query ? fetchPoints(query) : QVector<KnowledgePoint>();
+}
 
-        points.append(point);
+bool KnowledgeDatabaseManager::getPointText(int pointId, QString *content, QString *imagePath) const
+{
+    if (!database.isOpen()) {
+        return false;
     }
 
-    return points;
+    QSqlQuery *query = cachedQuery("SELECT content, image_path FROM knowledge_points WHERE id = ?");
+    if (!query) {
+        return false;
+    }
+
+    query->bindValue(0, pointId);
+    bool found = false;
+    if (query->exec() && query->next()) {
+        *content = query->value(0).toString();
+        *imagePath = query->value(1).toString();
+        found = true;
+    }
+    query->finish();
+    return found;
+}
+
+bool KnowledgeDatabaseManager::forEachPoint(const std::function<bool(const KnowledgePoint &)> &visitor) const
+{
+    if (!database.isOpen()) {
+        qDebug() << "数据库未连接";
+        return false;
+    }
+
+    QSqlQuery *query = cachedQuery(
+        "SELECT " POINT_COLUMNS " FROM knowledge_points ORDER BY id ASC");
+    if (!query) {
+        return false;
+    }
+
+    if (!query->exec()) {
+        qDebug() << "读取知识点失败:" << query->lastError().text();
+        return false;
+    }
+
+    bool completed = true;
+    while (query->next()) {
+        if (!visitor(readPoint(*query))) {
+            completed = false;
+            break;
+        }
+    }
+
+    query->finish();
+    return completed;
 }
 
 bool KnowledgeDatabaseManager::addPoint(const KnowledgePoint &point)
@@ -135,35 +585,53 @@ bool KnowledgeDatabaseManager::addPoint(const KnowledgePoint &point)
         return false;
     }
 
-    QSqlQuery query;
-    query.prepare(
-        "INSERT INTO knowledge_points "
-        "(title, content, image_path, category, difficulty, status, mastery_level, "
-        "created_date, last_reviewed, next_review, review_count, tags) "
-        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)"
-        );
+    QSqlQuery *query = cachedQuery(
+        "INSERT INTO knowledge_points (" POINT_COLUMNS ") "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    if (!query) {
+        return false;
+    }
 
-    query.addBindValue(point.title);
-    query.addBindValue(point.content);
-    query.addBindValue(point.imagePath);
-    query.addBindValue(point.category);
-    query.addBindValue(point.difficulty);
-    query.addBindValue(point.status);
-    query.addBindValue(point.masteryLevel);
-    query.addBindValue(point.createdDate);
-    query.addBindValue(point.lastReviewed);
-    query.addBindValue(point.nextReview);
-    query.addBindValue(point.reviewCount);
-    query.addBindValue(point.tags);
+    bindPoint(query, point);
 
-    if (!query.exec()) {
-        qDebug() << "添加知识点失败:" << query.lastError().text();
+    if (!query->exec()) {
+        qDebug() << "添加知识点失败:" << query->lastError().text();
         return false;
     }
 
     return true;
 }
 
+bool KnowledgeDatabaseManager::addPoints(const QVector<KnowledgePoint> &points)
+{
+    if (!database.isOpen()) {
+        qDebug() << "数据库未连接";
+        return false;
+    }
+
+    if (points.isEmpty()) {
+        return true;
+    }
+
+    QSqlQuery *query = cachedQuery(
+        "INSERT INTO knowledge_points (" POINT_COLUMNS ") "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    if (!query || !beginTransaction()) {
+        return false;
+    }
+
+    for (const KnowledgePoint &point : points) {
+        bindPoint(query, point);
+        if (!query->exec()) {
+            qDebug() << "批量添加知识点失败:" << query->lastError().text();
+            rollbackTransaction();
+            return false;
+        }
+    }
+
+    return commitTransaction();
+}
+
 bool KnowledgeDatabaseManager::updatePoint(const KnowledgePoint &point)
 {
     if (!database.isOpen()) {
@@ -171,29 +639,120 @@ bool KnowledgeDatabaseManager::updatePoint(const KnowledgePoint &point)
         return false;
     }
 
-    QSqlQuery query;
-    query.prepare(
+    QSqlQuery *query = cachedQuery(
         "UPDATE knowledge_points SET "
-        "title = ?, content = ?, image_path = ?, category = ?, difficulty = ?, "
+        "title = ?, content = ?, image_path = ?, category = ?, "
         "status = ?, mastery_level = ?, last_reviewed = ?, next_review = ?, "
-        "review_count = ?, tags = ? WHERE id = ?"
-        );
+        "review_count = ? WHERE id = ?");
+    if (!query) {
+        return false;
+    }
+
+    query->bindValue(0, point.title);
+    query->bindValue(1, point.content);
+    query->bindValue(2, point.imagePath);
+    query->bindValue(3, point.category);
+    query->bindValue(4, static_cast<int>(point.status));
+    query->bindValue(5, point.masteryLevel);
+    query->bindValue(6, dateToValue(point.lastReviewDate));
+    query->bindValue(7, dateToValue(point.nextReviewDate));
+    query->bindValue(8, point.reviewCount);
+    query->bindValue(9, point.id);
+
+    if (!query->exec()) {
+        qDebug() << "更新知识点失败:" << query->lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+bool KnowledgeDatabaseManager::savePoint(const KnowledgePoint &point)
+{
+    if (!database.isOpen()) {
+        qDebug() << "数据库未连接";
+        return false;
+    }
+
+    QSqlQuery *query = cachedQuery(
+        "INSERT INTO knowledge_points (" POINT_COLUMNS ") "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?) "
+        "ON CONFLICT(id) DO UPDATE SET "
+        "title = excluded.title, content = excluded.content, "
+        "image_path = excluded.image_path, category = excluded.category, "
+        "status = excluded.status, mastery_level = excluded.mastery_level, "
+        "last_reviewed = excluded.last_reviewed, next_review = excluded.next_review, "
+        "review_count = excluded.review_count");
+    if (!query) {
+        return false;
+    }
 
-    query.addBindValue(point.title);
-    query.addBindValue(point.content);
-    query.addBindValue(point.imagePath);
-    query.addBindValue(point.category);
-    query.addBindValue(point.difficulty);
-    query.addBindValue(point.status);
-    query.addBindValue(point.masteryLevel);
-    query.addBindValue(point.lastReviewed);
-    query.addBindValue(point.nextReview);
-    query.addBindValue(point.reviewCount);
-    query.addBindValue(point.tags);
-    query.addBindValue(point.id);
+    bindPoint(query, point);
 
-    if (!query.exec()) {
-        qDebug() << "更新知识点失败:" << query.lastError().text();
+    if (!query->exec()) {
+        qDebug() << "保存知识点失败:" << query->lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+bool KnowledgeDatabaseManager::savePointMetadata(const KnowledgePoint &point)
+{
+    if (!database.isOpen()) {
+        qDebug() << "数据库未连接";
+        return false;
+    }
+
+    QSqlQuery *query = cachedQuery(
+        "UPDATE knowledge_points SET "
+        "title = ?, category = ?, status = ?, mastery_level = ?, "
+        "last_reviewed = ?, next_review = ?, review_count = ? WHERE id = ?");
+    if (!query) {
+        return false;
+    }
+
+    query->bindValue(0, point.title);
+    query->bindValue(1, point.category);
+    query->bindValue(2, static_cast<int>(point.status));
+    query->bindValue(3, point.masteryLevel);
+    query->bindValue(4, dateToValue(point.lastReviewDate));
+    query->bindValue(5, dateToValue(point.nextReviewDate));
+    query->bindValue(6, point.reviewCount);
+    query->bindValue(7, point.id);
+
+    if (!query->exec()) {
+        qDebug() << "保存知识点元数据失败:" << query->lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+bool KnowledgeDatabaseManager::saveReviewState(const KnowledgePoint &point)
+{
+    if (!database.isOpen()) {
+        qDebug() << "数据库未连接";
+        return false;
+    }
+
+    QSqlQuery *query = cachedQuery(
+        "UPDATE knowledge_points SET "
+        "status = ?, mastery_level = ?, last_reviewed = ?, next_review = ?, "
+        "review_count = ? WHERE id = ?");
+    if (!query) {
+        return false;
+    }
+
+    query->bindValue(0, static_cast<int>(point.status));
+    query->bindValue(1, point.masteryLevel);
+    query->bindValue(2, dateToValue(point.lastReviewDate));
+    query->bindValue(3, dateToValue(point.nextReviewDate));
+    query->bindValue(4, point.reviewCount);
+    query->bindValue(5, point.id);
+
+    if (!query->exec()) {
+        qDebug() << "保存复习排程失败:" << query->lastError().text();
         return false;
     }
 
@@ -207,12 +766,15 @@ bool KnowledgeDatabaseManager::deletePoint(int pointId)
         return false;
     }
 
-    QSqlQuery query;
-    query.prepare("DELETE FROM knowledge_points WHERE id = ?");
-    query.addBindValue(pointId);
+    QSqlQuery *query = cachedQuery("DELETE FROM knowledge_points WHERE id = ?");
+    if (!query) {
+        return false;
+    }
 
-    if (!query.exec()) {
-        qDebug() << "删除知识点失败:" << query.lastError().text();
+    query->bindValue(0, pointId);
+
+    if (!query->exec()) {
+        qDebug() << "删除知识点失败:" << query->lastError().text();
         return false;
     }
 
@@ -227,33 +789,38 @@ bool KnowledgeDatabaseManager::markAsReviewed(int pointId, int effectiveness)
     }
 
     // 更新知识点表的复习信息
-    QSqlQuery query;
-    query.prepare(
+    QSqlQuery *query = cachedQuery(
         "UPDATE knowledge_points SET "
-        "last_reviewed = datetime('now'), "
+        "last_reviewed = ?, "
         "review_count = review_count + 1, "
         "mastery_level = MIN(100, mastery_level + ?) "
-        "WHERE id = ?"
-        );
-    query.addBindValue(effectiveness * 5); // 每次复习增加掌握度
-    query.addBindValue(pointId);
+        "WHERE id = ?");
+    if (!query) {
+        return false;
+    }
+
+    query->bindValue(0, todayDayNumber());
+    query->bindValue(1, effectiveness * 5); // 每次复习增加掌握度
+    query->bindValue(2, pointId);
 
-    if (!query.exec()) {
-        qDebug() << "标记复习失败:" << query.lastError().text();
+    if (!query->exec()) {
+        qDebug() << "标记复习失败:" << query->lastError().text();
         return false;
     }
 
     // 添加到复习历史
-    QSqlQuery historyQuery;
-    historyQuery.prepare(
+    QSqlQuery *historyQuery = cachedQuery(
         "INSERT INTO review_history (point_id, review_date, effectiveness) "
-        "VALUES (?, datetime('now'), ?)"
-        );
-    historyQuery.addBindValue(pointId);
-    historyQuery.addBindValue(effectiveness);
+        "VALUES (?, datetime('now'), ?)");
+    if (!historyQuery) {
+        return true;
+    }
 
-    if (!historyQuery.exec()) {
-        qDebug() << "添加复习历史失败:" << historyQuery.lastError().text();
+    historyQuery->bindValue(0, pointId);
+    historyQuery->bindValue(1, effectiveness);
+
+    if (!historyQuery->exec()) {
+        qDebug() << "添加复习历史失败:" << historyQuery->lastError().text();
     }
 
     return true;
@@ -265,11 +832,13 @@ int KnowledgeDatabaseManager::getTotalCount() const
         return 0;
     }
 
-    QSqlQuery query("SELECT COUNT(*) FROM knowledge_points");
-    if (query.next()) {
-        return query.value(0).toInt();
+    QSqlQuery *query = cachedQuery("SELECT COUNT(*) FROM knowledge_points");
+    int count = 0;
+    if (query && query->exec() && query->next()) {
+        count = query->value(0).toInt();
     }
-    return 0;
+    if (query) query->finish();
+    return count;
 }
 
 int KnowledgeDatabaseManager::getDueForReviewCount() const
@@ -278,11 +847,18 @@ int KnowledgeDatabaseManager::getDueForReviewCount() const
         return 0;
     }
 
-    QSqlQuery query("SELECT COUNT(*) FROM knowledge_points WHERE next_review <= date('now')");
-    if (query.next()) {
-        return query.value(0).toInt();
+    // 与 KnowledgePointStore::isDue 相同：复习中且已到期，没有日期也算。
+    // 走 idx_points_status_next_review 的范围扫描
+    QSqlQuery *query = cachedQuery(
+        "SELECT COUNT(*) FROM knowledge_points "
+        "WHERE status = 2 AND (next_review IS NULL OR next_review <= ?)"); // 2 表示复习中
+    if (query) query->bindValue(0, todayDayNumber());
+    int count = 0;
+    if (query && query->exec() && query->next()) {
+        count = query->value(0).toInt();
     }
-    return 0;
+    if (query) query->finish();
+    return count;
 }
 
 int KnowledgeDatabaseManager::getMasteredCount() const
@@ -291,66 +867,170 @@ int KnowledgeDatabaseManager::getMasteredCount() const
         return 0;
     }
 
-    QSqlQuery query("SELECT COUNT(*) FROM knowledge_points WHERE status = 3"); // 3 表示已掌握
-    if (query.next()) {
-        return query.value(0).toInt();
+    QSqlQuery *query = cachedQuery(
+        "SELECT COUNT(*) FROM knowledge_points WHERE status = 3"); // 3 表示已掌握
+    int count = 0;
+    if (query && query->exec() && query->next()) {
+        count = query->value(0).toInt();
     }
-    return 0;
+    if (query) query->finish();
+    return count;
 }
 
 QVector<KnowledgePoint> KnowledgeDatabaseManager::getPointsByStatus(int status) const
 {
-    QVector<KnowledgePoint> points;
-
     if (!database.isOpen()) {
-        return points;
+        return {};
     }
 
-    QSqlQuery query;
-    query.prepare("SELECT * FROM knowledge_points WHERE status = ? ORDER BY next_review ASC");
-    query.addBindValue(status);
+    QSqlQuery *query = cachedQuery(
+        "SELECT " POINT_COLUMNS " FROM knowledge_points "
+        "WHERE status = ? ORDER BY next_review ASC");
+    if (!query) {
+        return {};
+    }
 
-    if (query.exec()) {
-        while (query.next()) {
-            KnowledgePoint point;
-            point.id = query.value("id").toInt();
-            point.title = query.value("title").toString();
-            // ... 填充其他字段
-            points.append(point);
-        }
+    query->bindValue(0, status);
+    return fetchPoints(query);
+}
+
+QVector<KnowledgePoint> KnowledgeDatabaseManager::getPointsByCategory(const QString &category) const
+{
+    if (!database.isOpen()) {
+        return {};
     }
 
-    return points;
+    QSqlQuery *query = cachedQuery(
+        "SELECT " POINT_COLUMNS " FROM knowledge_points "
+        "WHERE category = ? ORDER BY next_review ASC");
+    if (!query) {
+        return {};
+    }
+
+    query->bindValue(0, category);
+    return fetchPoints(query);
 }
 
-QVector<KnowledgePoint> KnowledgeDatabaseManager::searchPoints(const QString &keyword) const
+QVector<KnowledgePoint> KnowledgeDatabaseManager::getDuePoints(const QDate &date) const
 {
-    QVector<KnowledgePoint> points;
+    if (!database.isOpen()) {
+        return {};
+    }
+
+    // 今日复习列表：下次复习日期不晚于 date 且尚未掌握
+    QSqlQuery *query = cachedQuery(
+        "SELECT " POINT_COLUMNS " FROM knowledge_points "
+        "WHERE next_review <= ? AND status != 3 ORDER BY next_review ASC");
+    if (!query) {
+        return {};
+    }
+
+    query->bindValue(0, date.toJulianDay());
+    return fetchPoints(query);
+}
 
+QVector<KnowledgePoint> KnowledgeDatabaseManager::searchPoints(const QString &keyword, int limit) const
+{
     if (!database.isOpen()) {
-        return points;
+        return {};
     }
 
-    QSqlQuery query;
-    query.prepare(
-        "SELECT * FROM knowledge_points "
-        "WHERE title LIKE ? OR content LIKE ? OR tags LIKE ? "
-        "ORDER BY next_review ASC"
-        );
-    QString searchPattern = "%" + keyword + "%";
-    query.addBindValue(searchPattern);
-    query.addBindValue(searchPattern);
-    query.addBindValue(searchPattern);
-
-    if (query.exec()) {
-        while (query.next()) {
-            KnowledgePoint point;
-            point.id = query.value("id").toInt();
-            point.title = query.value("title").toString();
-            // ... 填充其他字段
-            points.append(point);
+    // 三个字符及以上的词走全文索引；trigram 索引本身是子串匹配，
+    // 因此 "词*" 形式的前缀查询只需去掉星号。更短的词只能用 LIKE 过滤
+    QStringList matchTerms;
+    QStringList likeTerms;
+    const QStringList terms = keyword.simplified().split(' ', Qt::SkipEmptyParts);
+    for (QString term : terms) {
+        while (term.endsWith('*')) {
+            term.chop(1);
+        }
+        if (term.isEmpty()) {
+            continue;
+        }
+
+        if (ftsAvailable && term.size() >= 3) {
+            matchTerms.append('"' + term.replace('"', "\"\"") + '"');
+        } else {
+            term.replace('\\', "\\\\").replace('%', "\\%").replace('_', "\\_");
+            likeTerms.append('%' + term + '%');
         }
     }
 
-    return points;
+    if (matchTerms.isEmpty() && likeTerms.isEmpty()) {
+        return {};
+    }
+
+    QString sql = "SELECT " POINT_COLUMNS " FROM knowledge_points";
+    if (!matchTerms.isEmpty()) {
+        // 按 BM25 排序，标题命中权重最高
+        sql += " JOIN (SELECT rowid AS fts_id, bm25(knowledge_fts, 10.0, 1.0, 5.0) AS score "
+               "FROM knowledge_fts WHERE knowledge_fts MATCH ?) ON id = fts_id";
+    }
+
+    QStringList conditions;
+    for (int i = 0; i < likeTerms.size(); ++i) {
+        conditions.append("(title LIKE ? ESCAPE '\\' OR content LIKE ? ESCAPE '\\' "
+                          "OR tags LIKE ? ESCAPE '\\')");
+    }
+    if (!conditions.isEmpty()) {
+        sql += " WHERE " + conditions.join(" AND ");
+    }
+
+    sql += matchTerms.isEmpty() ? " ORDER BY next_review ASC" : " ORDER BY score ASC";
+    sql += " LIMIT ?";
+
+    QSqlQuery *query = cachedQuery(sql);
+    if (!query) {
+        return {};
+    }
+
+    int bindIndex = 0;
+    if (!matchTerms.isEmpty()) {
+        query->bindValue(bindIndex++, matchTerms.join(' '));
+    }
+    for (const QString &pattern : std::as_const(likeTerms)) {
+        query->bindValue(bindIndex++, pattern);
+        query->bindValue(bindIndex++, pattern);
+        query->bindValue(bindIndex++, pattern);
+    }
+    query->bindValue(bindIndex, limit > 0 ? limit : -1);
+
+    return fetchPoints(query);
+}
+
+QVector<int> KnowledgeDatabaseManager::searchContentIds(const QString &text) const
+{
+    QVector<int> ids;
+    if (!database.isOpen() || text.isEmpty()) {
+        return ids;
+    }
+
+    // trigram 索引上的短语查询就是子串匹配；一两个字符只能逐行 LIKE
+    QSqlQuery *query = nullptr;
+    if (ftsAvailable && text.size() >= 3) {
+        query = cachedQuery("SELECT rowid FROM knowledge_fts WHERE knowledge_fts MATCH ? ORDER BY rowid");
+        if (query) {
+            query->bindValue(0, "content : \"" + QString(text).replace('"', "\"\"") + '"');
+        }
+    } else {
+        query = cachedQuery("SELECT id FROM knowledge_points WHERE content LIKE ? ESCAPE '\\' ORDER BY id");
+        if (query) {
+            QString pattern = text;
+            pattern.replace('\\', "\\\\").replace('%', "\\%").replace('_', "\\_");
+            query->bindValue(0, '%' + pattern + '%');
+        }
+    }
+    if (!query) {
+        return ids;
+    }
+
+    if (!query->exec()) {
+        qDebug() << "搜索内容失败:" << query->lastError().text();
+        return ids;
+    }
+    while (query->next()) {
+        ids.append(query->value(0).toInt());
+    }
+    query->finish();
+    return ids;
 }
@@ -5,41 +5,68 @@
 #include <QSqlDatabase>
 #include <QSqlQuery>
 #include <QSqlError>
-
-struct KnowledgePoint {
-    int id;
-    QString title;
-    QString content;
-    QString imagePath;
-    QString category;
-    int difficulty;
-    int status;
-    int masteryLevel;
-    QString createdDate;
-    QString lastReviewed;
-    QString nextReview;
-    int reviewCount;
-    QString tags;
-};
+#include <QVector>
+#include <QHash>
+#include <functional>
+#include "knowledgepoint.h"
 
 class KnowledgeDatabaseManager : public QObject
 {
     Q_OBJECT
 
 public:
-    explicit KnowledgeDatabaseManager(QObject *parent = nullptr);
+    // connectionName 为空时使用默认连接；其他线程需要使用各自的连接名
+    explicit KnowledgeDatabaseManager(QObject *parent = nullptr,
+                                      const QString &connectionName = QString());
     ~KnowledgeDatabaseManager();
 
     bool initializeDatabase(const QString &dbPath = "");
+    // 只读打开：不建表、不迁移、不改日志模式，也就不会拿写锁。
+    // 数据库必须已由主连接初始化过
+    bool openReadOnly(const QString &dbPath);
+    // 当前线程的只读连接：第一次调用时打开，之后复用，线程结束时关闭。
+    // 供线程池里的后台任务使用，打不开时返回 nullptr
+    static KnowledgeDatabaseManager *readOnlyConnection(const QString &dbPath);
     bool isConnected() const;
+    QString path() const;
+
+    // 事务
+    bool beginTransaction();
+    bool commitTransaction();
+    void rollbackTransaction();
+    // 默认 synchronous = NORMAL，WAL 下断电可能丢失最后几次提交；
+    // 设为 true 时之后的提交都先 fsync 日志文件，直到再设回 false
+    bool setFullSync(bool full);
+
+    // 数据代数：每次提交事务加一，可用来判断缓存是否过期
+    qint64 generation() const;
 
     // CRUD 操作
     QVector<KnowledgePoint> getAllPoints() const;
+    // 只读取列表和排程需要的字段，content 与 imagePath 为空，按ID排序
+    QVector<KnowledgePoint> getPointSummaries() const;
+    bool getPointText(int pointId, QString *content, QString *imagePath) const;
     QVector<KnowledgePoint> getPointsByStatus(int status) const;
-    QVector<KnowledgePoint> searchPoints(const QString &keyword) const;
+    QVector<KnowledgePoint> getPointsByCategory(const QString &category) const;
+    QVector<KnowledgePoint> getDuePoints(const QDate &date) const;
+    // 按空格拆词、全部命中，按 BM25 排序。三个字符及以上的词走 FTS5 trigram 索引；
+    // 一两个字符的词（多数中文词）trigram 无法索引，只能对候选行（或整表）做 LIKE 扫描
+    QVector<KnowledgePoint> searchPoints(const QString &keyword, int limit = -1) const;
+    // 内容包含 text（整段作为一个子串）的知识点ID，按ID排序。实时过滤在搜索索引
+    // 建好前用它检查不在内存中的内容；长度限制与 searchPoints 相同
+    QVector<int> searchContentIds(const QString &text) const;
+    // 按ID顺序逐条读取，不把整个集合放进内存；visitor 返回 false 时停止
+    bool forEachPoint(const std::function<bool(const KnowledgePoint &)> &visitor) const;
 
     bool addPoint(const KnowledgePoint &point);
+    // 批量插入：同一事务、同一预编译语句；ID 小于等于 0 的由数据库分配
+    bool addPoints(const QVector<KnowledgePoint> &points);
     bool updatePoint(const KnowledgePoint &point);
+    bool savePoint(const KnowledgePoint &point); // 按ID插入或更新
+    // 只更新元数据列，内容和图片路径保持不变；用于内容不在内存中的知识点
+    bool savePointMetadata(const KnowledgePoint &point);
+    // 只更新复习排程（日期、状态、掌握程度、复习次数），不触发全文索引更新
+    bool saveReviewState(const KnowledgePoint &point);
     bool deletePoint(int pointId);
     bool markAsReviewed(int pointId, int effectiveness);
 
@@ -51,7 +78,19 @@ public:
 private:
     QSqlDatabase database;
     QString databasePath;
+    bool ftsAvailable = false; // FTS5 trigram 全文索引是否可用
+
+    // 预编译语句缓存，以 SQL 文本为键，连接关闭前释放
+    mutable QHash<QString, QSqlQuery *> statementCache;
+
+    bool configureConnection();
     bool createTables();
+    bool migrateDatesToDayNumbers();
+    bool createFullTextIndex();
+    QSqlQuery *cachedQuery(const QString &sql) const;
+    QVector<KnowledgePoint> fetchPoints(QSqlQuery *query) const;
+    static KnowledgePoint readPoint(const QSqlQuery &query);
+    static void bindPoint(QSqlQuery *query, const KnowledgePoint &point);
 };
 
 #endif // KNOWLEDGEDATABASEMANAGER_H
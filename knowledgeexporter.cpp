@@ -0,0 +1,126 @@
+#include "knowledgeexporter.h"
+#include "knowledgedatabasemanager.h"
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QThread>
+#include <QDebug>
+#include <utility>
+
+// 每导出这么多条发送一次进度，避免跨线程信号过多
+static const int kProgressInterval = 500;
+
+KnowledgeExporter::KnowledgeExporter(const QString &fileName, Format format, QObject *parent)
+    : QObject(parent)
+    , m_fileName(fileName)
+    , m_format(format)
+{
+}
+
+void KnowledgeExporter::setDatabasePath(const QString &databasePath)
+{
+    m_databasePath = databasePath;
+}
+
+void KnowledgeExporter::setPoints(const KnowledgePointTable &points)
+{
+    m_points = points;
+}
+
+QJsonObject KnowledgeExporter::toJson(const KnowledgePoint &point)
+{
+    QJsonObject jsonObject;
+    jsonObject["id"] = point.id;
+    jsonObject["title"] = point.title;
+    jsonObject["content"] = point.content;
+    jsonObject["imagePath"] = point.imagePath;
+    jsonObject["category"] = point.category;
+    jsonObject["status"] = static_cast<int>(point.status);
+    jsonObject["masteryLevel"] = point.masteryLevel;
+    jsonObject["createDate"] = point.createDate.toString(Qt::ISODate);
+    jsonObject["lastReviewDate"] = point.lastReviewDate.toString(Qt::ISODate);
+    jsonObject["nextReviewDate"] = point.nextReviewDate.toString(Qt::ISODate);
+    jsonObject["reviewCount"] = point.reviewCount;
+    return jsonObject;
+}
+
+void KnowledgeExporter::run()
+{
+    QSaveFile file(m_fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        emit finished(false, file.errorString());
+        return;
+    }
+
+    if (m_format == JsonArray) {
+        file.write("[\n");
+    }
+
+    m_exported = 0;
+    bool completed = true;
+    auto visitor = [this, &file](const KnowledgePoint &point) {
+        return writePoint(file, point);
+    };
+
+    if (!m_databasePath.isEmpty()) {
+        // 工作线程使用独立的只读连接：不重复建表，也不拿写锁
+        KnowledgeDatabaseManager database(nullptr,
+                                          QString("knowledge_export_%1").arg(quintptr(this)));
+        if (!database.openReadOnly(m_databasePath)) {
+            file.cancelWriting();
+            emit finished(false, "无法打开数据库");
+            return;
+        }
+        m_total = database.getTotalCount();
+        completed = database.forEachPoint(visitor);
+    } else {
+        m_total = m_points.size();
+        for (int row = 0; row < m_points.size(); ++row) {
+            if (!visitor(m_points.pointAt(row))) {
+                completed = false;
+                break;
+            }
+        }
+    }
+
+    if (!completed) {
+        file.cancelWriting();
+        emit finished(false, QThread::currentThread()->isInterruptionRequested()
+                                 ? QString("导出已取消") : file.errorString());
+        return;
+    }
+
+    if (m_format == JsonArray) {
+        file.write(m_exported > 0 ? "\n]\n" : "]\n");
+    }
+
+    if (!file.commit()) {
+        emit finished(false, file.errorString());
+        return;
+    }
+
+    emit progress(m_exported, m_total);
+    emit finished(true, QString());
+}
+
+bool KnowledgeExporter::writePoint(QSaveFile &file, const KnowledgePoint &point)
+{
+    if (QThread::currentThread()->isInterruptionRequested()) {
+        return false;
+    }
+
+    QByteArray line = QJsonDocument(toJson(point)).toJson(QJsonDocument::Compact);
+    if (m_format == JsonArray) {
+        line.prepend(m_exported > 0 ? ",\n    " : "    ");
+    } else {
+        line.append('\n');
+    }
+
+    if (file.write(line) != line.size()) {
+        return false;
+    }
+
+    if (++m_exported % kProgressInterval == 0) {
+        emit progress(m_exported, m_total);
+    }
+    return true;
+}
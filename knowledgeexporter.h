@@ -0,0 +1,49 @@
+#ifndef KNOWLEDGEEXPORTER_H
+#define KNOWLEDGEEXPORTER_H
+
+#include <QObject>
+#include <QJsonObject>
+#include "knowledgepointtable.h"
+
+class QSaveFile;
+
+// 流式导出：逐条序列化知识点并写入 QSaveFile，内存占用与集合大小无关。
+// 通过 moveToThread() 放到工作线程后调用 run()
+class KnowledgeExporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Format {
+        JsonArray,  // 与旧版导出兼容的 JSON 数组
+        NdJson      // 每行一个 JSON 对象
+    };
+
+    KnowledgeExporter(const QString &fileName, Format format, QObject *parent = nullptr);
+
+    // 二选一：从数据库逐行读取，或从内存集合的只读快照导出
+    void setDatabasePath(const QString &databasePath);
+    void setPoints(const KnowledgePointTable &points);
+
+    static QJsonObject toJson(const KnowledgePoint &point);
+
+public slots:
+    void run();
+
+signals:
+    void progress(int exported, int total);
+    void finished(bool ok, const QString &errorMessage);
+
+private:
+    QString m_fileName;
+    Format m_format;
+    QString m_databasePath;
+    KnowledgePointTable m_points; // 各列隐式共享，不复制数据
+
+    int m_exported = 0;
+    int m_total = 0;
+
+    bool writePoint(QSaveFile &file, const KnowledgePoint &point);
+};
+
+#endif // KNOWLEDGEEXPORTER_H
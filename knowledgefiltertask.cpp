@@ -0,0 +1,201 @@
+#include "knowledgefiltertask.h"
+#include "knowledgedatabasemanager.h"
+#include <QMetaObject>
+#include <QDebug>
+#include <algorithm>
+
+// 每处理这么多行检查一次是否已被更新的请求取代
+static const int kCancelCheckInterval = 1024;
+
+KnowledgeFilterTask::KnowledgeFilterTask(const KnowledgeFilter &filter, int generation,
+                                         const std::atomic<int> *latestGeneration)
+    : m_filter(filter)
+    , m_generation(generation)
+    , m_latestGeneration(latestGeneration)
+{
+}
+
+void KnowledgeFilterTask::setTable(const KnowledgePointTable &table)
+{
+    m_table = table;
+}
+
+void KnowledgeFilterTask::setSearchIndex(const KnowledgeSearchIndex &index)
+{
+    m_index = index;
+    m_hasIndex = true;
+}
+
+void KnowledgeFilterTask::setDueIds(const QVector<int> &dueIds)
+{
+    m_dueIds = dueIds;
+}
+
+void KnowledgeFilterTask::setDatabasePath(const QString &databasePath)
+{
+    m_databasePath = databasePath;
+}
+
+void KnowledgeFilterTask::setResultHandler(QObject *context, const ResultHandler &handler)
+{
+    m_context = context;
+    m_handler = handler;
+}
+
+bool KnowledgeFilterTask::isCancelled() const
+{
+    return m_latestGeneration->load(std::memory_order_relaxed) != m_generation;
+}
+
+void KnowledgeFilterTask::run()
+{
+    if (isCancelled()) {
+        return;
+    }
+
+    // 搜索：由 n-gram 索引给出匹配的知识点，索引未建好时改用 scan()（均已排序）
+    const bool searching = !m_filter.searchText.isEmpty();
+    QVector<int> found;
+    if (searching && !search(&found)) {
+        return;
+    }
+
+    // 分类和状态过滤只比较编号列，不读取文本
+    const bool filterCategory = !m_filter.category.isEmpty();
+    const int categoryId = filterCategory ? m_table.categoryId(m_filter.category) : -1;
+    const auto acceptRow = [&](int row) {
+        if (filterCategory && m_table.categoryIdAt(row) != categoryId) return false;
+        if (m_filter.status >= 0 && m_table.statusAt(row) != m_filter.status) return false;
+        // 到期ID来自全部未掌握知识点的索引，“今日待复习”只要复习中的，见 KnowledgePointStore::isDue
+        if (m_filter.dueOnly && m_table.statusAt(row) != STATUS_REVIEWING) return false;
+        return true;
+    };
+
+    QVector<int> ids;
+    ids.reserve(m_filter.dueOnly ? m_dueIds.size() : (searching ? found.size() : m_table.size()));
+    const auto acceptId = [&](int id) {
+        const int row = m_table.rowOf(id);
+        if (row >= 0 && acceptRow(row)) ids.append(id);
+    };
+
+    if (m_filter.dueOnly) {
+        // 今日待复习按到期先后排列
+        for (int id : std::as_const(m_dueIds)) {
+            if (!searching || std::binary_search(found.begin(), found.end(), id)) acceptId(id);
+        }
+    } else if (searching) {
+        for (int id : std::as_const(found)) acceptId(id);
+    } else {
+        for (int row = 0; row < m_table.size(); ++row) {
+            if (row % kCancelCheckInterval == 0 && isCancelled()) {
+                return;
+            }
+            if (acceptRow(row)) ids.append(m_table.idAt(row));
+        }
+    }
+
+    if (isCancelled()) {
+        return;
+    }
+
+    const ResultHandler handler = m_handler;
+    const int generation = m_generation;
+    QMetaObject::invokeMethod(m_context, [handler, generation, ids]() {
+        handler(generation, ids);
+    }, Qt::QueuedConnection);
+}
+
+bool KnowledgeFilterTask::search(QVector<int> *ids) const
+{
+    if (!m_hasIndex) {
+        return scan(ids);
+    }
+
+    const QString &text = m_filter.searchText;
+
+    // 一两个字的查询由单字、双字列表精确给出；更长的查询逐个核对原文
+    const QVector<int> candidates = m_index.candidates(text);
+    if (text.size() <= 2) {
+        *ids = candidates;
+        return true;
+    }
+
+    // 不常驻的内容用本线程的只读连接读取，连接在任务之间复用
+    KnowledgeDatabaseManager *database = nullptr;
+    bool databaseOpened = false;
+    for (int i = 0; i < candidates.size(); ++i) {
+        if (i % kCancelCheckInterval == 0 && isCancelled()) {
+            return false;
+        }
+
+        const int id = candidates.at(i);
+        const int row = m_table.rowOf(id);
+        if (row < 0) {
+            continue;
+        }
+
+        bool matched = m_table.titleAt(row).contains(text, Qt::CaseInsensitive);
+        if (!matched && m_table.isTextResident(row)) {
+            matched = m_table.contentAt(row).contains(text, Qt::CaseInsensitive);
+        } else if (!matched && !m_databasePath.isEmpty()) {
+            if (!databaseOpened) {
+                database = KnowledgeDatabaseManager::readOnlyConnection(m_databasePath);
+                databaseOpened = true;
+            }
+
+            QString content;
+            QString imagePath;
+            matched = database
+                      && database->getPointText(id, &content, &imagePath)
+                      && content.contains(text, Qt::CaseInsensitive);
+        }
+
+        if (matched) {
+            ids->append(id);
+        }
+    }
+    return true;
+}
+
+bool KnowledgeFilterTask::scan(QVector<int> *ids) const
+{
+    const QString &text = m_filter.searchText;
+
+    // 标题和常驻的内容直接比较，其余内容交给数据库的全文索引
+    QVector<int> pendingIds;
+    for (int row = 0; row < m_table.size(); ++row) {
+        if (row % kCancelCheckInterval == 0 && isCancelled()) {
+            return false;
+        }
+
+        const int id = m_table.idAt(row);
+        if (m_table.titleAt(row).contains(text, Qt::CaseInsensitive)) {
+            ids->append(id);
+        } else if (m_table.isTextResident(row)) {
+            if (m_table.contentAt(row).contains(text, Qt::CaseInsensitive)) {
+                ids->append(id);
+            }
+        } else {
+            pendingIds.append(id);
+        }
+    }
+
+    if (!pendingIds.isEmpty() && !m_databasePath.isEmpty()) {
+        KnowledgeDatabaseManager *database = KnowledgeDatabaseManager::readOnlyConnection(m_databasePath);
+        if (database) {
+            // 表格按ID排列，pendingIds 已经有序
+            const QVector<int> matched = database->searchContentIds(text);
+            if (isCancelled()) {
+                return false;
+            }
+            for (int id : matched) {
+                if (std::binary_search(pendingIds.begin(), pendingIds.end(), id)) {
+                    ids->append(id);
+                }
+            }
+        }
+    }
+
+    std::sort(ids->begin(), ids->end());
+    return true;
+}
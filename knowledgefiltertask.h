@@ -0,0 +1,60 @@
+#ifndef KNOWLEDGEFILTERTASK_H
+#define KNOWLEDGEFILTERTASK_H
+
+#include <QRunnable>
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <functional>
+#include "knowledgepointtable.h"
+#include "knowledgesearchindex.h"
+
+// 列表的过滤条件
+struct KnowledgeFilter
+{
+    QString searchText;
+    QString category;     // 为空时不限分类
+    int status = -1;      // KnowledgeStatus，-1 表示不限状态
+    bool dueOnly = false; // 今日待复习
+};
+
+// 在线程池里计算过滤结果。表格和搜索索引是隐式共享的副本，
+// 界面线程之后的修改只会让自己那份分离，不影响正在运行的任务。
+// 每个任务带一个代数：latestGeneration 变为更新的值时尽快放弃，
+// 不再投递结果；完成时把结果排队交给 context 所在线程的回调。
+// 不常驻的内容通过线程各自的只读数据库连接读取
+class KnowledgeFilterTask : public QRunnable
+{
+public:
+    typedef std::function<void(int generation, const QVector<int> &ids)> ResultHandler;
+
+    KnowledgeFilterTask(const KnowledgeFilter &filter, int generation,
+                        const std::atomic<int> *latestGeneration);
+
+    void setTable(const KnowledgePointTable &table);
+    void setSearchIndex(const KnowledgeSearchIndex &index); // 不设置时比较内存中的文本，其余查数据库的全文索引
+    void setDueIds(const QVector<int> &dueIds); // dueOnly 时的到期ID，按到期先后排列
+    void setDatabasePath(const QString &databasePath); // 核对不常驻的内容时使用
+    void setResultHandler(QObject *context, const ResultHandler &handler);
+
+    void run() override;
+
+private:
+    KnowledgeFilter m_filter;
+    int m_generation;
+    const std::atomic<int> *m_latestGeneration;
+    KnowledgePointTable m_table;
+    KnowledgeSearchIndex m_index;
+    bool m_hasIndex = false;
+    QVector<int> m_dueIds;
+    QString m_databasePath;
+    QObject *m_context = nullptr;
+    ResultHandler m_handler;
+
+    bool isCancelled() const;
+    bool search(QVector<int> *ids) const; // 被取消时返回 false
+    bool scan(QVector<int> *ids) const;   // 索引还没建好时使用，被取消时返回 false
+};
+
+#endif // KNOWLEDGEFILTERTASK_H
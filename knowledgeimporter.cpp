@@ -0,0 +1,158 @@
+#include "knowledgeimporter.h"
+#include "knowledgedatabasemanager.h"
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QThread>
+#include <QDebug>
+
+// 每批写入的知识点数量，一批一个事务
+static const int kBatchSize = 2000;
+static const qint64 kReadChunkSize = 64 * 1024;
+
+KnowledgeImporter::KnowledgeImporter(const QString &fileName, const QString &databasePath,
+                                     QObject *parent)
+    : QObject(parent)
+    , m_fileName(fileName)
+    , m_databasePath(databasePath)
+{
+}
+
+bool KnowledgeImporter::fromJson(const QJsonObject &jsonObject, KnowledgePoint *point)
+{
+    point->id = 0; // 导入的知识点由数据库重新分配ID，避免与本机冲突
+    point->title = jsonObject["title"].toString();
+    point->content = jsonObject["content"].toString();
+    point->imagePath = jsonObject["imagePath"].toString();
+    point->category = jsonObject["category"].toString();
+
+    int status = jsonObject["status"].toInt(STATUS_NEW);
+    if (status < STATUS_NEW || status > STATUS_MASTERED) {
+        status = STATUS_NEW;
+    }
+    point->status = static_cast<KnowledgeStatus>(status);
+    // 忘记会把掌握程度扣成负数；与存储和快照一样限制在 16 位有符号范围内，导出再导入不改变数据
+    point->masteryLevel = qBound(-32768, jsonObject["masteryLevel"].toInt(), 32767);
+    point->createDate = QDate::fromString(jsonObject["createDate"].toString(), Qt::ISODate);
+    point->lastReviewDate = QDate::fromString(jsonObject["lastReviewDate"].toString(), Qt::ISODate);
+    point->nextReviewDate = QDate::fromString(jsonObject["nextReviewDate"].toString(), Qt::ISODate);
+    point->reviewCount = jsonObject["reviewCount"].toInt();
+    point->reviewtureCount = 0;
+
+    return !point->title.isEmpty();
+}
+
+void KnowledgeImporter::run()
+{
+    QFile file(m_fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        emit finished(false, 0, file.errorString());
+        return;
+    }
+
+    KnowledgeDatabaseManager database(nullptr,
+                                      QString("knowledge_import_%1").arg(quintptr(this)));
+    if (!database.initializeDatabase(m_databasePath)) {
+        emit finished(false, 0, "无法打开数据库");
+        return;
+    }
+
+    m_batch.reserve(kBatchSize);
+    m_imported = 0;
+    m_skipped = 0;
+
+    // 逐字节扫描，取出每个顶层对象；同时适用于 JSON 数组和 NDJSON。
+    // 只在对象内部记录括号深度和字符串状态
+    QByteArray current;
+    int depth = 0;
+    bool inString = false;
+    bool escaped = false;
+
+    while (!file.atEnd()) {
+        if (QThread::currentThread()->isInterruptionRequested()) {
+            emit finished(false, m_imported, "导入已取消");
+            return;
+        }
+
+        const QByteArray chunk = file.read(kReadChunkSize);
+        for (char c : chunk) {
+            if (depth == 0) {
+                if (c == '{') {
+                    current.clear();
+                    current.append(c);
+                    depth = 1;
+                }
+                continue; // 对象之间的 [ ] , 和空白
+            }
+
+            current.append(c);
+            if (inString) {
+                if (escaped) {
+                    escaped = false;
+                } else if (c == '\\') {
+                    escaped = true;
+                } else if (c == '"') {
+                    inString = false;
+                }
+            } else if (c == '"') {
+                inString = true;
+            } else if (c == '{' || c == '[') {
+                ++depth;
+            } else if (c == '}' || c == ']') {
+                if (--depth == 0 && !addObject(current, database)) {
+                    emit finished(false, m_imported, "写入数据库失败");
+                    return;
+                }
+            }
+        }
+    }
+
+    if (depth != 0) {
+        qDebug() << "Import file ends inside an object, last object ignored";
+    }
+
+    if (!flushBatch(database)) {
+        emit finished(false, m_imported, "写入数据库失败");
+        return;
+    }
+
+    if (m_skipped > 0) {
+        qDebug() << "Skipped" << m_skipped << "invalid objects during import";
+    }
+    emit finished(true, m_imported, QString());
+}
+
+bool KnowledgeImporter::addObject(const QByteArray &json, KnowledgeDatabaseManager &database)
+{
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(json, &error);
+
+    KnowledgePoint point;
+    if (error.error != QJsonParseError::NoError || !doc.isObject()
+        || !fromJson(doc.object(), &point)) {
+        ++m_skipped;
+        return true;
+    }
+
+    m_batch.append(point);
+    if (m_batch.size() >= kBatchSize) {
+        return flushBatch(database);
+    }
+    return true;
+}
+
+bool KnowledgeImporter::flushBatch(KnowledgeDatabaseManager &database)
+{
+    if (m_batch.isEmpty()) {
+        return true;
+    }
+
+    if (!database.addPoints(m_batch)) {
+        return false;
+    }
+
+    m_imported += m_batch.size();
+    m_batch.clear();
+    emit progress(m_imported);
+    return true;
+}
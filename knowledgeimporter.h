@@ -0,0 +1,43 @@
+#ifndef KNOWLEDGEIMPORTER_H
+#define KNOWLEDGEIMPORTER_H
+
+#include <QObject>
+#include <QVector>
+#include <QJsonObject>
+#include "knowledgepoint.h"
+
+class KnowledgeDatabaseManager;
+
+// 流式导入 KnowledgeExporter 导出的 JSON 数组或 NDJSON 文件：
+// 分块读取文件，逐个解析对象，按批写入数据库。
+// 通过 moveToThread() 放到工作线程后调用 run()
+class KnowledgeImporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    KnowledgeImporter(const QString &fileName, const QString &databasePath,
+                      QObject *parent = nullptr);
+
+    static bool fromJson(const QJsonObject &jsonObject, KnowledgePoint *point);
+
+public slots:
+    void run();
+
+signals:
+    void progress(int imported);
+    void finished(bool ok, int imported, const QString &errorMessage);
+
+private:
+    QString m_fileName;
+    QString m_databasePath;
+
+    QVector<KnowledgePoint> m_batch;
+    int m_imported = 0;
+    int m_skipped = 0;
+
+    bool addObject(const QByteArray &json, KnowledgeDatabaseManager &database);
+    bool flushBatch(KnowledgeDatabaseManager &database);
+};
+
+#endif // KNOWLEDGEIMPORTER_H
@@ -0,0 +1,37 @@
+#include "knowledgeitemdelegate.h"
+#include "knowledgelistmodel.h"
+#include "knowledgepoint.h"
+#include <QPainter>
+
+KnowledgeItemDelegate::KnowledgeItemDelegate(QObject *parent)
+    : QStyledItemDelegate(parent)
+{
+}
+
+void KnowledgeItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
+                                  const QModelIndex &index) const
+{
+    const int status = index.data(KnowledgeListModel::StatusRole).toInt();
+    const bool due = index.data(KnowledgeListModel::DueRole).toBool();
+
+    // 先铺状态底色，选中和焦点效果由默认绘制叠加
+    painter->fillRect(option.rect, statusColor(status, due));
+    QStyledItemDelegate::paint(painter, option, index);
+}
+
+QColor KnowledgeItemDelegate::statusColor(int status, bool due)
+{
+    switch (status) {
+    case STATUS_NEW:
+        return QColor(Qt::lightGray);
+    case STATUS_LEARNING:
+        return QColor(255, 255, 200); // 浅黄色
+    case STATUS_REVIEWING:
+        return due ? QColor(255, 200, 200)  // 浅红色（需要复习）
+                   : QColor(200, 255, 200); // 浅绿色
+    case STATUS_MASTERED:
+        return QColor(Qt::cyan);
+    default:
+        return QColor(Qt::white);
+    }
+}
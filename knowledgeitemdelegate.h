@@ -0,0 +1,20 @@
+#ifndef KNOWLEDGEITEMDELEGATE_H
+#define KNOWLEDGEITEMDELEGATE_H
+
+#include <QStyledItemDelegate>
+
+// 按知识点状态绘制列表行背景色，颜色不再保存在每一行的数据里
+class KnowledgeItemDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    explicit KnowledgeItemDelegate(QObject *parent = nullptr);
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option,
+               const QModelIndex &index) const override;
+
+    static QColor statusColor(int status, bool due);
+};
+
+#endif // KNOWLEDGEITEMDELEGATE_H
@@ -0,0 +1,96 @@
+#include "knowledgelistmodel.h"
+#include "knowledgepointstore.h"
+#include <QDate>
+
+KnowledgeListModel::KnowledgeListModel(KnowledgePointStore *store, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_store(store)
+{
+}
+
+int KnowledgeListModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return m_ids.size();
+}
+
+QVariant KnowledgeListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_ids.size()) {
+        return QVariant();
+    }
+
+    const int id = m_ids.at(index.row());
+    if (role == IdRole) {
+        return id;
+    }
+
+    const KnowledgePointTable &table = m_store->table();
+    const int row = table.rowOf(id);
+    if (row < 0) {
+        return QVariant();
+    }
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::ToolTipRole:
+        return table.titleAt(row);
+    case StatusRole:
+        return int(table.statusAt(row));
+    case DueRole:
+        return table.nextReviewDayAt(row) <= KnowledgePointTable::toDay(QDate::currentDate());
+    default:
+        return QVariant();
+    }
+}
+
+void KnowledgeListModel::setIds(const QVector<int> &ids)
+{
+    beginResetModel();
+    m_ids = ids;
+    m_rows.clear();
+    m_rows.reserve(m_ids.size());
+    for (int row = 0; row < m_ids.size(); ++row) {
+        m_rows.insert(m_ids.at(row), row);
+    }
+    endResetModel();
+}
+
+int KnowledgeListModel::idAt(int row) const
+{
+    if (row < 0 || row >= m_ids.size()) {
+        return -1;
+    }
+    return m_ids.at(row);
+}
+
+int KnowledgeListModel::rowOf(int id) const
+{
+    return m_rows.value(id, -1);
+}
+
+void KnowledgeListModel::removePoint(int id)
+{
+    const int row = rowOf(id);
+    if (row >= 0) {
+        beginRemoveRows(QModelIndex(), row, row);
+        m_ids.removeAt(row);
+        m_rows.remove(id);
+        // 只有后面的行号前移
+        for (int i = row; i < m_ids.size(); ++i) {
+            m_rows[m_ids.at(i)] = i;
+        }
+        endRemoveRows();
+    }
+}
+
+void KnowledgeListModel::refreshPoint(int id)
+{
+    const int row = rowOf(id);
+    if (row >= 0) {
+        const QModelIndex changed = index(row);
+        emit dataChanged(changed, changed);
+    }
+}
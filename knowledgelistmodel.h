@@ -0,0 +1,40 @@
+#ifndef KNOWLEDGELISTMODEL_H
+#define KNOWLEDGELISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QVector>
+#include <QHash>
+
+class KnowledgePointStore;
+
+// 知识点列表模型：只保存过滤后的知识点ID，行数据在视图需要时才从存储读取，
+// 因此刷新和滚动只涉及可见行
+class KnowledgeListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        IdRole = Qt::UserRole, // 与旧版 QListWidgetItem 的 data(Qt::UserRole) 一致
+        StatusRole,
+        DueRole                // 是否已到复习日期
+    };
+
+    explicit KnowledgeListModel(KnowledgePointStore *store, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    void setIds(const QVector<int> &ids); // 替换过滤结果
+    int idAt(int row) const;
+    int rowOf(int id) const; // 不在列表中时返回 -1
+    void refreshPoint(int id); // 单个知识点变化时只重绘对应行
+    void removePoint(int id);  // 不再符合过滤条件时只移除对应行
+
+private:
+    KnowledgePointStore *m_store;
+    QVector<int> m_ids;
+    QHash<int, int> m_rows; // ID -> 行号，复习后定位行不必线性查找
+};
+
+#endif // KNOWLEDGELISTMODEL_H
@@ -0,0 +1,47 @@
+#ifndef KNOWLEDGEPOINT_H
+#define KNOWLEDGEPOINT_H
+
+#include <QString>
+#include <QDate>
+#include <QFlags>
+
+// 知识点状态枚举
+enum KnowledgeStatus {
+    STATUS_NEW,         // 新知识点
+    STATUS_LEARNING,    // 学习中
+    STATUS_REVIEWING,   // 复习中
+    STATUS_MASTERED     // 已掌握
+};
+
+// 知识点数据结构
+struct KnowledgePoint {
+    int id;
+    QString title;
+    QString content;
+    QString imagePath;
+    QString category;
+    KnowledgeStatus status;
+    int masteryLevel; // 掌握程度 0-100
+    QDate createDate;
+    QDate lastReviewDate;
+    QDate nextReviewDate;
+    int reviewCount;
+    int reviewtureCount;
+};
+
+// 知识点字段，用于只更新发生变化的部分
+enum KnowledgePointField {
+    FIELD_TITLE        = 0x01,
+    FIELD_CONTENT      = 0x02,
+    FIELD_IMAGE        = 0x04,
+    FIELD_CATEGORY     = 0x08,
+    FIELD_STATUS       = 0x10,
+    FIELD_MASTERY      = 0x20,
+    FIELD_REVIEW_DATES = 0x40,
+    FIELD_REVIEW_COUNT = 0x80,
+    FIELD_ALL          = 0xFF
+};
+Q_DECLARE_FLAGS(KnowledgePointFields, KnowledgePointField)
+Q_DECLARE_OPERATORS_FOR_FLAGS(KnowledgePointFields)
+
+#endif // KNOWLEDGEPOINT_H
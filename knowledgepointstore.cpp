@@ -0,0 +1,960 @@
+#include "knowledgepointstore.h"
+#include "knowledgedatabasemanager.h"
+#include "knowledgesnapshot.h"
+#include "persistenceworker.h"
+#include "reviewjournal.h"
+#include <QSettings>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QThread>
+#include <QTimer>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QMetaObject>
+#include <QDebug>
+#include <climits>
+#include <utility>
+
+// 注册表布局：points/<id>/<字段>
+static const char *const kPointsGroup = "points";
+
+// 内容 LRU 缓存保留的笔记数量
+static const int kTextCacheSize = 64;
+
+// 建索引任务每处理这么多行检查一次是否已被作废
+static const int kIndexCancelCheckInterval = 1024;
+
+// 在后台建立搜索索引：常驻的内容取自表格的隐式共享副本，
+// 其余内容通过线程的只读连接按ID顺序读出，读完即释放
+class SearchIndexBuildTask : public QRunnable
+{
+public:
+    SearchIndexBuildTask(KnowledgePointStore *store, const KnowledgePointTable &table,
+                         const QString &databasePath, int build, const std::atomic<int> *latestBuild)
+        : m_store(store)
+        , m_table(table)
+        , m_databasePath(databasePath)
+        , m_build(build)
+        , m_latestBuild(latestBuild)
+    {
+    }
+
+    void run() override
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        KnowledgeSearchIndex index;
+        for (int row = 0; row < m_table.size(); ++row) {
+            if (row % kIndexCancelCheckInterval == 0 && isCancelled()) {
+                return;
+            }
+            if (m_table.isTextResident(row)) {
+                index.addPoint(m_table.idAt(row), m_table.titleAt(row), m_table.contentAt(row));
+            }
+        }
+
+        if (!m_databasePath.isEmpty()) {
+            KnowledgeDatabaseManager *database = KnowledgeDatabaseManager::readOnlyConnection(m_databasePath);
+            if (!database) {
+                qDebug() << "Search index build could not open database:" << m_databasePath;
+                return;
+            }
+
+            int visited = 0;
+            const bool completed = database->forEachPoint([&](const KnowledgePoint &stored) {
+                if (++visited % kIndexCancelCheckInterval == 0 && isCancelled()) {
+                    return false;
+                }
+                const int row = m_table.rowOf(stored.id);
+                if (row >= 0 && !m_table.isTextResident(row)) {
+                    index.addPoint(stored.id, m_table.titleAt(row), stored.content);
+                }
+                return true;
+            });
+            if (!completed) {
+                return;
+            }
+        }
+
+        if (isCancelled()) {
+            return;
+        }
+        qDebug() << "Built search index for" << m_table.size() << "points in" << timer.elapsed() << "ms";
+
+        KnowledgePointStore *store = m_store;
+        const int build = m_build;
+        QMetaObject::invokeMethod(store, [store, build, index]() {
+            store->adoptSearchIndex(build, index);
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    KnowledgePointStore *m_store;
+    KnowledgePointTable m_table;
+    QString m_databasePath;
+    int m_build;
+    const std::atomic<int> *m_latestBuild;
+
+    bool isCancelled() const
+    {
+        return m_latestBuild->load(std::memory_order_relaxed) != m_build;
+    }
+};
+
+KnowledgePointStore::KnowledgePointStore(QObject *parent)
+    : QObject(parent)
+    , m_indexPool(new QThreadPool(this))
+    , m_dayTimer(new QTimer(this))
+    , m_database(new KnowledgeDatabaseManager(this))
+{
+    m_textCache.setMaxCost(kTextCacheSize);
+    m_indexPool->setMaxThreadCount(1);
+    m_dayTimer->setSingleShot(true);
+    connect(m_dayTimer, &QTimer::timeout, this, &KnowledgePointStore::recountDue);
+}
+
+KnowledgePointStore::~KnowledgePointStore()
+{
+    // 建索引任务引用了存储本身
+    ++m_searchIndexBuild;
+    m_indexPool->waitForDone();
+
+    if (m_writerThread) {
+        flush();
+        m_writerThread->quit();
+        m_writerThread->wait();
+    }
+}
+
+void KnowledgePointStore::load()
+{
+    qDebug() << "Loading knowledge points...";
+
+    // 重新加载前等待尚未提交的改动写入数据库
+    if (m_writer) {
+        flush();
+    }
+
+    m_table.clear();
+    m_textCache.clear();
+    m_dirtyIds.clear();
+    m_removedIds.clear();
+    m_nextId = 1;
+
+    m_useDatabase = m_database->isConnected() || m_database->initializeDatabase();
+    if (!m_useDatabase) {
+        qDebug() << "Database unavailable, falling back to QSettings";
+        loadFromSettings();
+        rebuildIndexes();
+        return;
+    }
+
+    qDebug() << "数据库路径:" << m_database->path();
+    migrateSettingsToDatabase();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // 快照与数据库代数一致时直接映射读取，否则从数据库加载并重建快照
+    const qint64 generation = m_database->generation();
+    if (KnowledgeSnapshot::read(snapshotPath(), generation, &m_table)) {
+        qDebug() << "Loaded" << m_table.size() << "knowledge points from snapshot in"
+                 << timer.elapsed() << "ms";
+    } else {
+        // 只加载摘要，内容在查看时按需读取
+        const QVector<KnowledgePoint> points = m_database->getPointSummaries();
+        m_table.reserve(points.size());
+        for (const KnowledgePoint &point : points) {
+            m_table.insert(point, false);
+        }
+        qDebug() << "Loaded" << m_table.size() << "knowledge points from database in"
+                 << timer.elapsed() << "ms";
+        KnowledgeSnapshot::write(snapshotPath(), generation, m_table);
+    }
+
+    if (!m_table.isEmpty()) {
+        m_nextId = m_table.lastId() + 1;
+    }
+
+    startWriter();
+
+    // 上次合并之后的复习记录还在日志里，重放后合并
+    replayJournal();
+    rebuildIndexes();
+}
+
+void KnowledgePointStore::startWriter()
+{
+    if (m_writer) {
+        return;
+    }
+
+    m_writerThread = new QThread(this);
+    m_writer = new PersistenceWorker(m_database->path(), journalPath());
+    m_writer->moveToThread(m_writerThread);
+
+    PersistenceWorker *writer = m_writer;
+    connect(m_writerThread, &QThread::started, writer, [writer]() { writer->open(); });
+    connect(m_writerThread, &QThread::finished, writer, &QObject::deleteLater);
+    connect(writer, &PersistenceWorker::writeFailed, this, &KnowledgePointStore::writeFailed);
+
+    m_writerThread->start();
+}
+
+qint64 KnowledgePointStore::flush()
+{
+    save();
+    if (!m_writer) {
+        return -1;
+    }
+
+    qint64 generation = -1;
+    PersistenceWorker *writer = m_writer;
+    QMetaObject::invokeMethod(writer, [writer, &generation]() {
+        generation = writer->flush();
+    }, Qt::BlockingQueuedConnection);
+    return generation;
+}
+
+void KnowledgePointStore::writeSnapshot()
+{
+    if (!m_useDatabase) {
+        return;
+    }
+
+    // 只有全部改动都已提交时，快照才与数据库代数对应
+    const qint64 generation = flush();
+    if (generation < 0) {
+        return;
+    }
+
+    KnowledgeSnapshot::write(snapshotPath(), generation, m_table);
+}
+
+QString KnowledgePointStore::snapshotPath() const
+{
+    return QFileInfo(m_database->path()).absolutePath() + "/knowledge_points.snapshot";
+}
+
+QString KnowledgePointStore::journalPath() const
+{
+    return QFileInfo(m_database->path()).absolutePath() + "/review.journal";
+}
+
+void KnowledgePointStore::replayJournal()
+{
+    const QVector<ReviewEvent> events = ReviewJournal::readAll(journalPath());
+    if (events.isEmpty()) {
+        return;
+    }
+
+    int applied = 0;
+    for (const ReviewEvent &event : events) {
+        const int row = m_table.rowOf(event.pointId);
+        if (row < 0) {
+            continue; // 复习后又被删除
+        }
+
+        KnowledgePoint point = m_table.pointAt(row);
+        point.status = event.status;
+        point.masteryLevel = event.masteryLevel;
+        point.reviewCount = event.reviewCount;
+        point.lastReviewDate = event.lastReviewDate;
+        point.nextReviewDate = event.nextReviewDate;
+        m_table.update(row, point, false);
+        m_dirtyIds.insert(event.pointId);
+        ++applied;
+    }
+
+    qDebug() << "Replayed" << applied << "of" << events.size() << "journaled reviews";
+    save();
+}
+
+void KnowledgePointStore::recordReview(const KnowledgePoint &point, int grade)
+{
+    const int row = m_table.rowOf(point.id);
+    if (row < 0) {
+        qDebug() << "Cannot review missing knowledge point:" << point.id;
+        return;
+    }
+
+    // 复习只改排程字段：在表格里的摘要上修改并比较，不为此读取内容
+    const KnowledgePoint stored = m_table.pointAt(row);
+    KnowledgePoint reviewed = stored;
+    reviewed.status = point.status;
+    reviewed.masteryLevel = point.masteryLevel;
+    reviewed.reviewCount = point.reviewCount;
+    reviewed.reviewtureCount = point.reviewtureCount;
+    reviewed.lastReviewDate = point.lastReviewDate;
+    reviewed.nextReviewDate = point.nextReviewDate;
+
+    if (!m_writer) {
+        m_dirtyIds.insert(point.id);
+        replacePoint(reviewed, stored);
+        save();
+        return;
+    }
+
+    replacePoint(reviewed, stored);
+
+    ReviewEvent event;
+    event.pointId = point.id;
+    event.timestamp = QDateTime::currentMSecsSinceEpoch();
+    event.grade = grade;
+    event.interval = point.lastReviewDate.isValid() && point.nextReviewDate.isValid()
+                         ? int(point.lastReviewDate.daysTo(point.nextReviewDate)) : 0;
+    event.status = point.status;
+    event.masteryLevel = point.masteryLevel;
+    event.reviewCount = point.reviewCount;
+    event.lastReviewDate = point.lastReviewDate;
+    event.nextReviewDate = point.nextReviewDate;
+
+    // 复习只追加一条日志，由持久化线程稍后合并进数据库
+    PersistenceWorker *writer = m_writer;
+    QMetaObject::invokeMethod(writer, [writer, event, reviewed]() {
+        writer->recordReview(event, reviewed);
+    }, Qt::QueuedConnection);
+}
+
+void KnowledgePointStore::save()
+{
+    if (m_dirtyIds.isEmpty() && m_removedIds.isEmpty()) {
+        return;
+    }
+
+    qDebug() << "Saving" << m_dirtyIds.size() << "changed and"
+             << m_removedIds.size() << "removed knowledge points...";
+
+    if (!m_writer) {
+        saveToSettings();
+        return;
+    }
+
+    // 只把改动过的知识点副本交给持久化线程，界面线程不等待磁盘。
+    // 内容不在内存中的知识点只写元数据列，不为保存去读内容，也不会把内容写成空
+    QVector<KnowledgePoint> upserts;
+    QVector<KnowledgePoint> metadataUpdates;
+    for (int id : std::as_const(m_dirtyIds)) {
+        const int row = m_table.rowOf(id);
+        if (row < 0) {
+            continue;
+        }
+        if (m_table.isTextResident(row)) {
+            upserts.append(m_table.pointAt(row));
+        } else {
+            metadataUpdates.append(m_table.pointAt(row));
+        }
+    }
+
+    QVector<int> removals;
+    removals.reserve(m_removedIds.size());
+    for (int id : std::as_const(m_removedIds)) {
+        removals.append(id);
+    }
+
+    m_dirtyIds.clear();
+    m_removedIds.clear();
+
+    PersistenceWorker *writer = m_writer;
+    QMetaObject::invokeMethod(writer, [writer, upserts, metadataUpdates, removals]() {
+        writer->enqueue(upserts, metadataUpdates, removals);
+    }, Qt::QueuedConnection);
+}
+
+void KnowledgePointStore::loadFromSettings()
+{
+    QSettings settings("MyCompany", "KnowledgeReview");
+    qDebug() << "设置文件路径:" << settings.fileName();
+
+    // 旧版本按排序位置保存为 point_N_ 键，首次启动时迁移
+    if (settings.contains("knowledgeCount")) {
+        migrateLegacySettings(settings);
+    }
+
+    settings.beginGroup(kPointsGroup);
+    const QStringList groups = settings.childGroups();
+    for (const QString &group : groups) {
+        KnowledgePoint point = readPoint(settings, group + "/");
+
+        // 验证数据有效性
+        if (point.id <= 0 || point.title.isEmpty() || point.id != group.toInt()) {
+            qDebug() << "Skipping invalid knowledge point:" << group;
+            continue;
+        }
+
+        m_table.insert(point);
+        if (point.id >= m_nextId) m_nextId = point.id + 1;
+    }
+    settings.endGroup();
+
+    qDebug() << "Total loaded:" << m_table.size() << "valid knowledge points";
+}
+
+void KnowledgePointStore::saveToSettings()
+{
+    QSettings settings("MyCompany", "KnowledgeReview");
+    settings.beginGroup(kPointsGroup);
+
+    for (int id : std::as_const(m_removedIds)) {
+        settings.remove(QString::number(id));
+    }
+
+    for (int id : std::as_const(m_dirtyIds)) {
+        const int row = m_table.rowOf(id);
+        if (row >= 0) {
+            writePoint(settings, point(id));
+        }
+    }
+
+    settings.endGroup();
+    settings.sync(); // 确保数据写入磁盘
+
+    m_dirtyIds.clear();
+    m_removedIds.clear();
+}
+
+bool KnowledgePointStore::usesDatabase() const
+{
+    return m_useDatabase;
+}
+
+QString KnowledgePointStore::databasePath() const
+{
+    return m_database->path();
+}
+
+bool KnowledgePointStore::contains(int id) const
+{
+    return m_table.contains(id);
+}
+
+KnowledgePoint KnowledgePointStore::point(int id) const
+{
+    const int row = m_table.rowOf(id);
+    if (row < 0) {
+        return KnowledgePoint();
+    }
+
+    KnowledgePoint point = m_table.pointAt(row);
+    if (!m_table.isTextResident(row)) {
+        loadText(id, &point.content, &point.imagePath);
+    }
+    return point;
+}
+
+bool KnowledgePointStore::loadText(int id, QString *content, QString *imagePath) const
+{
+    // 最近查看的笔记放在 LRU 缓存里，其余从数据库读取
+    if (const KnowledgePointText *text = m_textCache.object(id)) {
+        *content = text->content;
+        *imagePath = text->imagePath;
+        return true;
+    }
+
+    if (!m_database->getPointText(id, content, imagePath)) {
+        return false;
+    }
+
+    m_textCache.insert(id, new KnowledgePointText{*content, *imagePath});
+    return true;
+}
+
+const KnowledgePointTable &KnowledgePointStore::table() const
+{
+    return m_table;
+}
+
+int KnowledgePointStore::size() const
+{
+    return m_table.size();
+}
+
+bool KnowledgePointStore::isEmpty() const
+{
+    return m_table.isEmpty();
+}
+
+int KnowledgePointStore::addPoint(KnowledgePoint point)
+{
+    point.id = m_nextId++;
+    m_table.insert(point);
+    indexPoint(point, 1);
+    updateSearchIndex(point.id, nullptr, &point);
+    emit statisticsChanged();
+    m_dirtyIds.insert(point.id);
+    m_removedIds.remove(point.id);
+    return point.id;
+}
+
+void KnowledgePointStore::updatePoint(const KnowledgePoint &point)
+{
+    if (!m_table.contains(point.id)) {
+        qDebug() << "Cannot update missing knowledge point:" << point.id;
+        return;
+    }
+
+    m_dirtyIds.insert(point.id);
+    replacePoint(point);
+}
+
+void KnowledgePointStore::removePoint(int id)
+{
+    const int row = m_table.rowOf(id);
+    if (row < 0) {
+        return;
+    }
+
+    // 搜索索引需要旧内容才能移除对应的 gram
+    const bool tracked = m_searchIndexBuilt || m_searchIndexBuilding;
+    const KnowledgePoint removed = tracked ? point(id) : m_table.pointAt(row);
+    m_textCache.remove(id);
+    indexPoint(removed, -1);
+    updateSearchIndex(id, &removed, nullptr);
+    m_table.removeAt(row);
+    emit statisticsChanged();
+
+    m_dirtyIds.remove(id);
+    m_removedIds.insert(id);
+}
+
+void KnowledgePointStore::replacePoint(const KnowledgePoint &point)
+{
+    replacePoint(point, this->point(point.id)); // 与完整内容比较
+}
+
+void KnowledgePointStore::replacePoint(const KnowledgePoint &point, const KnowledgePoint &stored)
+{
+    const int row = m_table.rowOf(point.id);
+    const KnowledgePointFields fields = changedFields(stored, point);
+    if (!fields) {
+        return;
+    }
+
+    indexPoint(stored, -1);
+    indexPoint(point, 1);
+    if (fields & (FIELD_TITLE | FIELD_CONTENT)) {
+        updateSearchIndex(point.id, &stored, &point);
+    }
+
+    // 编辑过的内容常驻内存，直到下次加载；复习不改内容，不占用内存
+    const bool textChanged = fields & (FIELD_CONTENT | FIELD_IMAGE);
+    m_table.update(row, point, textChanged);
+    if (textChanged) {
+        m_textCache.remove(point.id);
+    }
+
+    emit statisticsChanged();
+    emit pointChanged(point.id, fields);
+}
+
+KnowledgePointFields KnowledgePointStore::changedFields(const KnowledgePoint &before,
+                                                        const KnowledgePoint &after)
+{
+    KnowledgePointFields fields;
+    if (before.title != after.title) fields |= FIELD_TITLE;
+    if (before.content != after.content) fields |= FIELD_CONTENT;
+    if (before.imagePath != after.imagePath) fields |= FIELD_IMAGE;
+    if (before.category != after.category) fields |= FIELD_CATEGORY;
+    if (before.status != after.status) fields |= FIELD_STATUS;
+    if (before.masteryLevel != after.masteryLevel) fields |= FIELD_MASTERY;
+    if (before.lastReviewDate != after.lastReviewDate || before.nextReviewDate != after.nextReviewDate) {
+        fields |= FIELD_REVIEW_DATES;
+    }
+    if (before.reviewCount != after.reviewCount || before.reviewtureCount != after.reviewtureCount) {
+        fields |= FIELD_REVIEW_COUNT;
+    }
+    return fields;
+}
+
+const QMap<QString, int> &KnowledgePointStore::categoryCounts() const
+{
+    return m_categoryCounts;
+}
+
+QVector<int> KnowledgePointStore::dueIds(const QDate &date, int limit) const
+{
+    QVector<int> ids;
+    const auto end = m_dueIndex.upper_bound(DueKey(dueDay(date), INT_MAX));
+    for (auto it = m_dueIndex.begin(); it != end && ids.size() != limit; ++it) {
+        ids.append(it->second);
+    }
+    return ids;
+}
+
+QVector<int> KnowledgePointStore::idsDueOn(const QDate &date) const
+{
+    QVector<int> ids;
+    const qint64 day = dueDay(date);
+    for (auto it = m_dueIndex.lower_bound(DueKey(day, INT_MIN));
+         it != m_dueIndex.end() && it->first == day; ++it) {
+        ids.append(it->second);
+    }
+    return ids;
+}
+
+QVector<int> KnowledgePointStore::nextDue(int count) const
+{
+    QVector<int> ids;
+    for (auto it = m_dueIndex.begin(); it != m_dueIndex.end() && ids.size() < count; ++it) {
+        ids.append(it->second);
+    }
+    return ids;
+}
+
+bool KnowledgePointStore::hasSearchIndex() const
+{
+    return m_searchIndexBuilt;
+}
+
+const KnowledgeSearchIndex &KnowledgePointStore::searchIndex() const
+{
+    return m_searchIndex;
+}
+
+void KnowledgePointStore::prepareSearchIndex()
+{
+    if (m_searchIndexBuilt || m_searchIndexBuilding) {
+        return;
+    }
+
+    m_searchIndexBuilding = true;
+    m_indexPool->start(new SearchIndexBuildTask(this, m_table,
+                                                m_useDatabase ? m_database->path() : QString(),
+                                                m_searchIndexBuild, &m_searchIndexBuild));
+}
+
+void KnowledgePointStore::adoptSearchIndex(int build, const KnowledgeSearchIndex &index)
+{
+    if (build != m_searchIndexBuild) {
+        return; // 建索引期间重新加载过
+    }
+
+    m_searchIndex = index;
+    m_searchIndexBuilt = true;
+    m_searchIndexBuilding = false;
+
+    // 补上建索引期间的改动：先移除旧文本再加入新文本，
+    // 无论任务读到的是改动前还是改动后的内容，结果都与当前内容一致
+    for (const SearchIndexEdit &edit : std::as_const(m_searchIndexEdits)) {
+        if (edit.removeOld) {
+            m_searchIndex.removePoint(edit.id, edit.oldTitle, edit.oldContent);
+        }
+        if (edit.addNew) {
+            m_searchIndex.addPoint(edit.id, edit.newTitle, edit.newContent);
+        }
+    }
+    m_searchIndexEdits.clear();
+}
+
+void KnowledgePointStore::updateSearchIndex(int id, const KnowledgePoint *before, const KnowledgePoint *after)
+{
+    if (m_searchIndexBuilt) {
+        if (before) {
+            m_searchIndex.removePoint(id, before->title, before->content);
+        }
+        if (after) {
+            m_searchIndex.addPoint(id, after->title, after->content);
+        }
+    } else if (m_searchIndexBuilding) {
+        SearchIndexEdit edit;
+        edit.id = id;
+        edit.removeOld = before != nullptr;
+        edit.oldTitle = before ? before->title : QString();
+        edit.oldContent = before ? before->content : QString();
+        edit.addNew = after != nullptr;
+        edit.newTitle = after ? after->title : QString();
+        edit.newContent = after ? after->content : QString();
+        m_searchIndexEdits.append(edit);
+    }
+}
+
+int KnowledgePointStore::dueCountOn(const QDate &date) const
+{
+    return date.isValid() ? m_dueHistogram.value(date.toJulianDay()) : 0;
+}
+
+qint64 KnowledgePointStore::dueDay(const QDate &date)
+{
+    // 没有复习日期的知识点排在最前，与 QDate 比较的结果一致
+    return KnowledgePointTable::toDay(date);
+}
+
+void KnowledgePointStore::indexPoint(const KnowledgePoint &point, int delta)
+{
+    indexCategory(point.category, delta);
+    countPoint(point, delta);
+
+    // 已掌握的知识点不再排队复习
+    if (point.status != STATUS_MASTERED) {
+        const DueKey key(dueDay(point.nextReviewDate), point.id);
+        if (delta > 0) {
+            m_dueIndex.insert(key);
+        } else {
+            m_dueIndex.erase(key);
+        }
+
+        if (point.nextReviewDate.isValid()) {
+            int &count = m_dueHistogram[key.first];
+            count += delta;
+            if (count <= 0) {
+                m_dueHistogram.remove(key.first);
+            }
+            emit dueCountChanged(point.nextReviewDate);
+        }
+    }
+}
+
+void KnowledgePointStore::rebuildIndexes()
+{
+    // 搜索索引在下一次搜索时重建，作废上一次还没完成的任务
+    ++m_searchIndexBuild;
+    m_searchIndex.clear();
+    m_searchIndexBuilt = false;
+    m_searchIndexBuilding = false;
+    m_searchIndexEdits.clear();
+
+    // 只读取状态、复习日期和ID三列
+    m_dueIndex.clear();
+    m_dueHistogram.clear();
+    for (int row = 0; row < m_table.size(); ++row) {
+        if (m_table.statusAt(row) != STATUS_MASTERED) {
+            const qint32 day = m_table.nextReviewDayAt(row);
+            m_dueIndex.emplace(day, m_table.idAt(row));
+            if (day != KnowledgePointTable::kNoDay) {
+                ++m_dueHistogram[day];
+            }
+        }
+    }
+    emit dueCountsReset();
+
+    rebuildCategoryIndex();
+    rebuildStatistics();
+}
+
+void KnowledgePointStore::indexCategory(const QString &category, int delta)
+{
+    if (category.isEmpty()) {
+        return;
+    }
+
+    auto it = m_categoryCounts.find(category);
+    if (it == m_categoryCounts.end()) {
+        if (delta > 0) {
+            m_categoryCounts.insert(category, delta);
+            emit categoryAdded(category);
+        }
+        return;
+    }
+
+    it.value() += delta;
+    if (it.value() <= 0) {
+        m_categoryCounts.erase(it);
+        emit categoryRemoved(category);
+    }
+}
+
+void KnowledgePointStore::rebuildCategoryIndex()
+{
+    // 先按分类编号计数，再换成分类名，不逐行比较字符串
+    QVector<int> counts(m_table.categoryCount(), 0);
+    for (int row = 0; row < m_table.size(); ++row) {
+        ++counts[m_table.categoryIdAt(row)];
+    }
+
+    m_categoryCounts.clear();
+    for (int categoryId = 0; categoryId < counts.size(); ++categoryId) {
+        const QString &category = m_table.categoryName(categoryId);
+        if (counts.at(categoryId) > 0 && !category.isEmpty()) {
+            m_categoryCounts.insert(category, counts.at(categoryId));
+        }
+    }
+    emit categoriesReset();
+}
+
+const KnowledgeStatistics &KnowledgePointStore::statistics() const
+{
+    return m_statistics;
+}
+
+void KnowledgePointStore::countPoint(const KnowledgePoint &point, int delta)
+{
+    m_statistics.total += delta;
+    if (point.status == STATUS_LEARNING) {
+        m_statistics.learning += delta;
+    } else if (point.status == STATUS_MASTERED) {
+        m_statistics.mastered += delta;
+    }
+    if (isDue(point, m_statisticsDate)) {
+        m_statistics.due += delta;
+    }
+}
+
+bool KnowledgePointStore::isDue(const KnowledgePoint &point, const QDate &date)
+{
+    // 无效日期比任何有效日期都小，没有复习日期的知识点也算到期
+    return point.status == STATUS_REVIEWING && point.nextReviewDate <= date;
+}
+
+void KnowledgePointStore::rebuildStatistics()
+{
+    m_statistics = KnowledgeStatistics();
+    m_statisticsDate = QDate::currentDate();
+
+    // 只读取状态和复习日期两列
+    const qint32 today = KnowledgePointTable::toDay(m_statisticsDate);
+    m_statistics.total = m_table.size();
+    for (int row = 0; row < m_table.size(); ++row) {
+        const KnowledgeStatus status = m_table.statusAt(row);
+        if (status == STATUS_LEARNING) {
+            ++m_statistics.learning;
+        } else if (status == STATUS_MASTERED) {
+            ++m_statistics.mastered;
+        }
+        if (status == STATUS_REVIEWING && m_table.nextReviewDayAt(row) <= today) {
+            ++m_statistics.due; // 与 isDue 相同
+        }
+    }
+    scheduleDayRollover();
+    emit statisticsChanged();
+}
+
+void KnowledgePointStore::recountDue()
+{
+    // 日期变化只影响“待复习”，其余计数不变；只遍历索引中已到期的部分
+    m_statisticsDate = QDate::currentDate();
+    m_statistics.due = 0;
+    const auto end = m_dueIndex.upper_bound(DueKey(dueDay(m_statisticsDate), INT_MAX));
+    for (auto it = m_dueIndex.begin(); it != end; ++it) {
+        const int row = m_table.rowOf(it->second);
+        if (row >= 0 && m_table.statusAt(row) == STATUS_REVIEWING) {
+            ++m_statistics.due;
+        }
+    }
+    scheduleDayRollover();
+    emit statisticsChanged();
+}
+
+void KnowledgePointStore::scheduleDayRollover()
+{
+    const QDateTime now = QDateTime::currentDateTime();
+    const QDateTime midnight(now.date().addDays(1), QTime(0, 0));
+    // 多等一秒，避免定时器略早触发时日期还没变
+    m_dayTimer->start(int(now.msecsTo(midnight)) + 1000);
+}
+
+void KnowledgePointStore::migrateLegacySettings(QSettings &settings)
+{
+    int count = settings.value("knowledgeCount", 0).toInt();
+    qDebug() << "Migrating" << count << "legacy knowledge points";
+
+    static const char *const legacyKeys[] = {
+        "id", "title", "content", "imagePath", "category", "status",
+        "masteryLevel", "createDate", "lastReviewDate", "nextReviewDate", "reviewCount"
+    };
+
+    QList<KnowledgePoint> legacyPoints;
+    for (int i = 0; i < count; ++i) {
+        KnowledgePoint point = readPoint(settings, QString("point_%1_").arg(i));
+        if (point.id > 0 && !point.title.isEmpty()) {
+            legacyPoints.append(point);
+        }
+    }
+
+    settings.beginGroup(kPointsGroup);
+    for (const KnowledgePoint &point : legacyPoints) {
+        writePoint(settings, point);
+    }
+    settings.endGroup();
+
+    for (int i = 0; i < count; ++i) {
+        QString prefix = QString("point_%1_").arg(i);
+        for (const char *key : legacyKeys) {
+            settings.remove(prefix + key);
+        }
+    }
+    settings.remove("knowledgeCount");
+    settings.sync();
+}
+
+void KnowledgePointStore::migrateSettingsToDatabase()
+{
+    QSettings settings("MyCompany", "KnowledgeReview");
+    if (!settings.contains("knowledgeCount") && !settings.childGroups().contains(kPointsGroup)) {
+        return;
+    }
+
+    // 先把旧的 point_N_ 布局整理为按ID保存的布局
+    if (settings.contains("knowledgeCount")) {
+        migrateLegacySettings(settings);
+    }
+
+    // 逐条读取、逐条写入，不在内存中保留整个集合
+    if (!m_database->beginTransaction()) {
+        return;
+    }
+
+    settings.beginGroup(kPointsGroup);
+    const QStringList groups = settings.childGroups();
+    int migrated = 0;
+    bool ok = true;
+    for (const QString &group : groups) {
+        KnowledgePoint point = readPoint(settings, group + "/");
+        if (point.id <= 0 || point.title.isEmpty()) {
+            continue;
+        }
+        if (!m_database->savePoint(point)) {
+            ok = false;
+            break;
+        }
+        ++migrated;
+    }
+    settings.endGroup();
+
+    if (!ok || !m_database->commitTransaction()) {
+        // 注册表数据保持不变，下次启动时重新迁移
+        m_database->rollbackTransaction();
+        qDebug() << "Migration to database failed, keeping QSettings data";
+        return;
+    }
+
+    settings.remove(kPointsGroup);
+    settings.sync();
+    qDebug() << "Migrated" << migrated << "knowledge points from QSettings to database";
+}
+
+void KnowledgePointStore::writePoint(QSettings &settings, const KnowledgePoint &point)
+{
+    QString prefix = QString("%1/").arg(point.id);
+
+    settings.setValue(prefix + "id", point.id);
+    settings.setValue(prefix + "title", point.title);
+    settings.setValue(prefix + "content", point.content);
+    settings.setValue(prefix + "imagePath", point.imagePath);
+    settings.setValue(prefix + "category", point.category);
+    settings.setValue(prefix + "status", static_cast<int>(point.status));
+    settings.setValue(prefix + "masteryLevel", point.masteryLevel);
+    settings.setValue(prefix + "createDate", point.createDate);
+    settings.setValue(prefix + "lastReviewDate", point.lastReviewDate);
+    settings.setValue(prefix + "nextReviewDate", point.nextReviewDate);
+    settings.setValue(prefix + "reviewCount", point.reviewCount);
+}
+
+KnowledgePoint KnowledgePointStore::readPoint(QSettings &settings, const QString &prefix)
+{
+    KnowledgePoint point;
+    point.id = settings.value(prefix + "id").toInt();
+    point.title = settings.value(prefix + "title").toString();
+    point.content = settings.value(prefix + "content").toString();
+    point.imagePath = settings.value(prefix + "imagePath").toString();
+    point.category = settings.value(prefix + "category").toString();
+    point.status = static_cast<KnowledgeStatus>(settings.value(prefix + "status").toInt());
+    point.masteryLevel = settings.value(prefix + "masteryLevel").toInt();
+    point.createDate = settings.value(prefix + "createDate").toDate();
+    point.lastReviewDate = settings.value(prefix + "lastReviewDate").toDate();
+    point.nextReviewDate = settings.value(prefix + "nextReviewDate").toDate();
+    point.reviewCount = settings.value(prefix + "reviewCount").toInt();
+    point.reviewtureCount = 0;
+    return point;
+}
@@ -0,0 +1,178 @@
+#ifndef KNOWLEDGEPOINTSTORE_H
+#define KNOWLEDGEPOINTSTORE_H
+
+#include <QObject>
+#include <QMap>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QDate>
+#include <QCache>
+#include "knowledgepoint.h"
+#include "knowledgesearchindex.h"
+#include "knowledgepointtable.h"
+#include <atomic>
+#include <set>
+#include <utility>
+
+class QSettings;
+class QThread;
+class QTimer;
+class QThreadPool;
+class KnowledgeDatabaseManager;
+class PersistenceWorker;
+
+// 统计面板的计数，随每次增删改增量维护
+struct KnowledgeStatistics
+{
+    int total = 0;
+    int due = 0;      // 复习中且已到复习日期，见 KnowledgePointStore::isDue
+    int learning = 0;
+    int mastered = 0;
+};
+
+// 按需读取的内容和图片路径
+struct KnowledgePointText
+{
+    QString content;
+    QString imagePath;
+};
+
+// 知识点存储：以稳定的知识点ID为键保存到 SQLite 数据库，
+// 只写入发生变化的知识点，只删除被删除的知识点。
+// 写入由持久化线程完成，界面线程只提交改动的副本。
+// 数据库无法打开时退回到注册表（points/<id>/<字段>）同步保存
+class KnowledgePointStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit KnowledgePointStore(QObject *parent = nullptr);
+    ~KnowledgePointStore();
+
+    void load();
+    void save();   // 把脏数据交给持久化线程，不等待写入
+    qint64 flush(); // 写入屏障：等待全部改动提交，返回数据代数，失败返回 -1
+    void writeSnapshot(); // 保存后写入启动快照，退出时调用
+
+    bool usesDatabase() const;
+    QString databasePath() const;
+
+    bool contains(int id) const;
+    KnowledgePoint point(int id) const; // 完整的知识点，内容不常驻时从缓存或数据库读取
+    const KnowledgePointTable &table() const; // 按列读取，用于过滤和遍历
+    int size() const;
+    bool isEmpty() const;
+
+    // 分类索引：分类名 -> 知识点数量（不含空分类），随增删改增量维护
+    const QMap<QString, int> &categoryCounts() const;
+
+    const KnowledgeStatistics &statistics() const;
+
+    // 复习中且复习日期不晚于 date（没有日期也算）。“待复习”计数、“今日待复习”过滤
+    // 和数据库的 getDueForReviewCount 都使用这一定义。复习日期索引和日历热力图
+    // 包含全部未掌握的知识点，是它的超集
+    static bool isDue(const KnowledgePoint &point, const QDate &date);
+
+    // 实时搜索用的 n-gram 索引：第一次搜索时调用 prepareSearchIndex() 在后台线程建立，
+    // 建好后随增删改增量维护；从不搜索就不读取内容、不占内存。过滤任务持有它的
+    // 隐式共享副本，在工作线程里求候选并核对原文；还没建好时 hasSearchIndex() 为 false，
+    // 过滤任务改用数据库的全文索引
+    void prepareSearchIndex();
+    bool hasSearchIndex() const;
+    const KnowledgeSearchIndex &searchIndex() const;
+
+    // 复习日期索引（未掌握的知识点，按 (复习日期, ID) 排序）
+    QVector<int> dueIds(const QDate &date, int limit = -1) const; // 在 date 当天或之前到期
+    QVector<int> idsDueOn(const QDate &date) const;               // 恰好在 date 到期
+    QVector<int> nextDue(int count) const;                        // 最早到期的 count 个
+    int dueCountOn(const QDate &date) const;                      // 日历热力图：当天到期数量
+
+    int addPoint(KnowledgePoint point); // 分配新ID并返回
+    void updatePoint(const KnowledgePoint &point);
+    void removePoint(int id);
+
+    // 记录一次复习：只追加复习日志，由持久化线程合并进数据库
+    void recordReview(const KnowledgePoint &point, int grade);
+
+signals:
+    void writeFailed(const QString &errorMessage);
+
+    // 只在分类出现或消失时发出；重新加载后发出 categoriesReset()
+    void categoryAdded(const QString &category);
+    void categoryRemoved(const QString &category);
+    void categoriesReset();
+
+    void statisticsChanged();
+
+    // 修改或复习后发出，fields 为实际变化的字段
+    void pointChanged(int id, KnowledgePointFields fields);
+
+    void dueCountChanged(const QDate &date); // 某一天的到期数量变化
+    void dueCountsReset();
+
+private:
+    KnowledgePointTable m_table;
+    mutable QCache<int, KnowledgePointText> m_textCache; // 最近查看的笔记内容
+    QSet<int> m_dirtyIds;   // 新增或修改、尚未写入的知识点
+    QSet<int> m_removedIds; // 已删除、尚未从注册表移除的知识点
+    int m_nextId = 1;
+    QMap<QString, int> m_categoryCounts;
+    typedef std::pair<qint64, int> DueKey; // (复习日期的儒略日, ID)
+    std::set<DueKey> m_dueIndex;
+    QHash<qint64, int> m_dueHistogram; // 儒略日 -> 当天到期的未掌握知识点数量
+    KnowledgeSearchIndex m_searchIndex;
+    bool m_searchIndexBuilt = false;
+    bool m_searchIndexBuilding = false;
+    std::atomic<int> m_searchIndexBuild{0}; // 每次重新加载加一，作废还在进行的建索引任务
+    QThreadPool *m_indexPool;
+
+    // 后台建索引期间的文本改动，建好后按顺序补到索引上
+    struct SearchIndexEdit
+    {
+        int id;
+        bool removeOld;
+        QString oldTitle;
+        QString oldContent;
+        bool addNew;
+        QString newTitle;
+        QString newContent;
+    };
+    QVector<SearchIndexEdit> m_searchIndexEdits;
+    KnowledgeStatistics m_statistics;
+    QDate m_statisticsDate; // “待复习”计数所依据的日期
+    QTimer *m_dayTimer;     // 跨过午夜时重算“待复习”
+    KnowledgeDatabaseManager *m_database;
+    bool m_useDatabase = false;
+    QThread *m_writerThread = nullptr;
+    PersistenceWorker *m_writer = nullptr;
+
+    bool loadText(int id, QString *content, QString *imagePath) const;
+    static qint64 dueDay(const QDate &date);
+    static KnowledgePointFields changedFields(const KnowledgePoint &before, const KnowledgePoint &after);
+    void replacePoint(const KnowledgePoint &point); // 更新索引后替换并发出 pointChanged
+    void replacePoint(const KnowledgePoint &point, const KnowledgePoint &stored); // stored 为替换前的版本
+    void indexPoint(const KnowledgePoint &point, int delta); // 同步更新分类、统计和复习日期索引
+    void rebuildIndexes();
+    void adoptSearchIndex(int build, const KnowledgeSearchIndex &index);
+    void updateSearchIndex(int id, const KnowledgePoint *before, const KnowledgePoint *after);
+    friend class SearchIndexBuildTask;
+    void indexCategory(const QString &category, int delta);
+    void rebuildCategoryIndex();
+    void countPoint(const KnowledgePoint &point, int delta);
+    void rebuildStatistics();
+    void recountDue();
+    void scheduleDayRollover();
+    QString snapshotPath() const;
+    QString journalPath() const;
+    void startWriter();
+    void replayJournal();
+    void loadFromSettings();
+    void saveToSettings();
+    void migrateLegacySettings(QSettings &settings);
+    void migrateSettingsToDatabase();
+    static void writePoint(QSettings &settings, const KnowledgePoint &point);
+    static KnowledgePoint readPoint(QSettings &settings, const QString &prefix);
+};
+
+#endif // KNOWLEDGEPOINTSTORE_H
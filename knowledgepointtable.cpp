@@ -0,0 +1,170 @@
+#include "knowledgepointtable.h"
+#include <algorithm>
+#include <limits>
+
+const qint32 KnowledgePointTable::kNoDay = std::numeric_limits<qint32>::min();
+
+qint32 KnowledgePointTable::toDay(const QDate &date)
+{
+    return date.isValid() ? qint32(date.toJulianDay()) : kNoDay;
+}
+
+QDate KnowledgePointTable::fromDay(qint32 day)
+{
+    return day == kNoDay ? QDate() : QDate::fromJulianDay(day);
+}
+
+void KnowledgePointTable::clear()
+{
+    m_ids.clear();
+    m_status.clear();
+    m_mastery.clear();
+    m_nextReviewDay.clear();
+    m_categoryIds.clear();
+    m_createDay.clear();
+    m_lastReviewDay.clear();
+    m_reviewCount.clear();
+    m_reviewtureCount.clear();
+    m_text.clear();
+    m_categoryNames.clear();
+    m_categoryLookup.clear();
+}
+
+void KnowledgePointTable::reserve(int size)
+{
+    m_ids.reserve(size);
+    m_status.reserve(size);
+    m_mastery.reserve(size);
+    m_nextReviewDay.reserve(size);
+    m_categoryIds.reserve(size);
+    m_createDay.reserve(size);
+    m_lastReviewDay.reserve(size);
+    m_reviewCount.reserve(size);
+    m_reviewtureCount.reserve(size);
+    m_text.reserve(size);
+}
+
+int KnowledgePointTable::rowOf(int id) const
+{
+    auto it = std::lower_bound(m_ids.constBegin(), m_ids.constEnd(), id);
+    if (it == m_ids.constEnd() || *it != id) {
+        return -1;
+    }
+    return int(it - m_ids.constBegin());
+}
+
+int KnowledgePointTable::categoryId(const QString &category) const
+{
+    return m_categoryLookup.value(category, -1);
+}
+
+int KnowledgePointTable::internCategory(const QString &category)
+{
+    if (m_categoryNames.isEmpty()) {
+        m_categoryNames.append(QString());
+        m_categoryLookup.insert(QString(), 0);
+    }
+
+    auto it = m_categoryLookup.constFind(category);
+    if (it != m_categoryLookup.constEnd()) {
+        return it.value();
+    }
+
+    const int id = m_categoryNames.size();
+    m_categoryNames.append(category);
+    m_categoryLookup.insert(category, id);
+    return id;
+}
+
+KnowledgePoint KnowledgePointTable::pointAt(int row) const
+{
+    KnowledgePoint point;
+    point.id = m_ids.at(row);
+    point.title = m_text.at(row).title;
+    point.content = m_text.at(row).content;
+    point.imagePath = m_text.at(row).imagePath;
+    point.category = m_categoryNames.at(m_categoryIds.at(row));
+    point.status = static_cast<KnowledgeStatus>(m_status.at(row));
+    point.masteryLevel = m_mastery.at(row);
+    point.createDate = fromDay(m_createDay.at(row));
+    point.lastReviewDate = fromDay(m_lastReviewDay.at(row));
+    point.nextReviewDate = fromDay(m_nextReviewDay.at(row));
+    point.reviewCount = m_reviewCount.at(row);
+    point.reviewtureCount = m_reviewtureCount.at(row);
+    return point;
+}
+
+KnowledgePoint KnowledgePointTable::point(int id) const
+{
+    const int row = rowOf(id);
+    if (row < 0) {
+        return KnowledgePoint();
+    }
+    return pointAt(row);
+}
+
+void KnowledgePointTable::setRow(int row, const KnowledgePoint &point, bool withText)
+{
+    m_status[row] = quint8(point.status);
+    m_mastery[row] = qint16(point.masteryLevel);
+    m_nextReviewDay[row] = toDay(point.nextReviewDate);
+    m_categoryIds[row] = internCategory(point.category);
+    m_createDay[row] = toDay(point.createDate);
+    m_lastReviewDay[row] = toDay(point.lastReviewDate);
+    m_reviewCount[row] = point.reviewCount;
+    m_reviewtureCount[row] = point.reviewtureCount;
+
+    TextRow &text = m_text[row];
+    text.title = point.title;
+    if (withText) {
+        text.content = point.content;
+        text.imagePath = point.imagePath;
+        text.resident = true;
+    }
+}
+
+void KnowledgePointTable::insert(const KnowledgePoint &point, bool withText)
+{
+    // 常见情况：新ID最大，直接追加
+    int row = m_ids.size();
+    if (!m_ids.isEmpty() && point.id <= m_ids.last()) {
+        auto it = std::lower_bound(m_ids.begin(), m_ids.end(), point.id);
+        row = int(it - m_ids.begin());
+        if (it != m_ids.end() && *it == point.id) {
+            setRow(row, point, withText);
+            return;
+        }
+    }
+
+    m_ids.insert(row, point.id);
+    m_status.insert(row, 0);
+    m_mastery.insert(row, 0);
+    m_nextReviewDay.insert(row, kNoDay);
+    m_categoryIds.insert(row, 0);
+    m_createDay.insert(row, kNoDay);
+    m_lastReviewDay.insert(row, kNoDay);
+    m_reviewCount.insert(row, 0);
+    m_reviewtureCount.insert(row, 0);
+    m_text.insert(row, TextRow());
+    setRow(row, point, withText);
+}
+
+void KnowledgePointTable::update(int row, const KnowledgePoint &point, bool withText)
+{
+    Q_ASSERT(m_ids.at(row) == point.id);
+    setRow(row, point, withText);
+}
+
+void KnowledgePointTable::removeAt(int row)
+{
+    m_ids.removeAt(row);
+    m_status.removeAt(row);
+    m_mastery.removeAt(row);
+    m_nextReviewDay.removeAt(row);
+    m_categoryIds.removeAt(row);
+    m_createDay.removeAt(row);
+    m_lastReviewDay.removeAt(row);
+    m_reviewCount.removeAt(row);
+    m_reviewtureCount.removeAt(row);
+    m_text.removeAt(row);
+}
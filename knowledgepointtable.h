@@ -0,0 +1,82 @@
+#ifndef KNOWLEDGEPOINTTABLE_H
+#define KNOWLEDGEPOINTTABLE_H
+
+#include <QVector>
+#include <QStringList>
+#include <QHash>
+#include "knowledgepoint.h"
+
+// 按列保存的知识点集合：过滤和统计用到的字段（ID、状态、掌握程度、
+// 复习日期的儒略日、分类编号）各占一个连续数组，标题、内容等长文本单独存放。
+// 分类名只保存一份，行里只存编号。行按ID递增排列，按ID查找用二分查找。
+// 内容和图片路径可以不常驻：从数据库只加载摘要时为空，由存储按需读取
+class KnowledgePointTable
+{
+public:
+    static const qint32 kNoDay; // 无效日期，比任何有效日期都小，与 QDate 的比较结果一致
+
+    static qint32 toDay(const QDate &date);
+    static QDate fromDay(qint32 day);
+
+    int size() const { return m_ids.size(); }
+    bool isEmpty() const { return m_ids.isEmpty(); }
+    void clear();
+    void reserve(int size);
+
+    int rowOf(int id) const; // 不存在时返回 -1
+    bool contains(int id) const { return rowOf(id) >= 0; }
+    int lastId() const { return m_ids.isEmpty() ? 0 : m_ids.last(); }
+
+    // 热数据列
+    int idAt(int row) const { return m_ids.at(row); }
+    KnowledgeStatus statusAt(int row) const { return static_cast<KnowledgeStatus>(m_status.at(row)); }
+    int masteryAt(int row) const { return m_mastery.at(row); }
+    qint32 nextReviewDayAt(int row) const { return m_nextReviewDay.at(row); }
+    int categoryIdAt(int row) const { return m_categoryIds.at(row); }
+
+    // 冷数据
+    const QString &titleAt(int row) const { return m_text.at(row).title; }
+    const QString &contentAt(int row) const { return m_text.at(row).content; }
+    bool isTextResident(int row) const { return m_text.at(row).resident; } // 内容和图片路径是否在内存中
+
+    // 分类名驻留表：编号 0 是空分类
+    int categoryCount() const { return m_categoryNames.size(); }
+    const QString &categoryName(int categoryId) const { return m_categoryNames.at(categoryId); }
+    int categoryId(const QString &category) const; // 从未出现过的分类返回 -1
+
+    KnowledgePoint pointAt(int row) const;
+    KnowledgePoint point(int id) const; // 不存在时返回默认值
+
+    // withText 为 false 时不保存内容和图片路径（只有摘要），为 true 时常驻内存
+    void insert(const KnowledgePoint &point, bool withText = true); // 按ID插入，已存在时替换
+    void update(int row, const KnowledgePoint &point, bool withText = true);
+    void removeAt(int row);
+
+private:
+    struct TextRow {
+        QString title;
+        QString content;
+        QString imagePath;
+        bool resident = false;
+    };
+
+    QVector<int> m_ids;
+    QVector<quint8> m_status;
+    QVector<qint16> m_mastery;
+    QVector<qint32> m_nextReviewDay;
+    QVector<int> m_categoryIds;
+
+    QVector<qint32> m_createDay;
+    QVector<qint32> m_lastReviewDay;
+    QVector<int> m_reviewCount;
+    QVector<int> m_reviewtureCount;
+    QVector<TextRow> m_text;
+
+    QStringList m_categoryNames;
+    QHash<QString, int> m_categoryLookup;
+
+    int internCategory(const QString &category);
+    void setRow(int row, const KnowledgePoint &point, bool withText);
+};
+
+#endif // KNOWLEDGEPOINTTABLE_H
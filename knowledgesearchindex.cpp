@@ -0,0 +1,139 @@
+#include "knowledgesearchindex.h"
+#include <algorithm>
+#include <utility>
+
+// gram 编码：单字为字符本身，双字为 (1 << 32) | (前一字 << 16) | 后一字
+static inline quint64 unigramKey(ushort c)
+{
+    return c;
+}
+
+static inline quint64 bigramKey(ushort a, ushort b)
+{
+    return (quint64(1) << 32) | (quint64(a) << 16) | b;
+}
+
+void KnowledgeSearchIndex::clear()
+{
+    m_postings.clear();
+}
+
+void KnowledgeSearchIndex::collectGrams(const QString &text, QVector<quint64> *grams)
+{
+    const QString folded = text.toCaseFolded();
+    const int length = folded.size();
+    for (int i = 0; i < length; ++i) {
+        const ushort c = folded.at(i).unicode();
+        grams->append(unigramKey(c));
+        if (i + 1 < length) {
+            grams->append(bigramKey(c, folded.at(i + 1).unicode()));
+        }
+    }
+}
+
+void KnowledgeSearchIndex::addPoint(int id, const QString &title, const QString &content)
+{
+    QVector<quint64> grams;
+    grams.reserve(2 * (title.size() + content.size()));
+    collectGrams(title, &grams);
+    collectGrams(content, &grams);
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+
+    for (quint64 gram : std::as_const(grams)) {
+        QVector<int> &ids = m_postings[gram];
+        if (ids.isEmpty() || ids.last() < id) {
+            ids.append(id); // 常见情况：按ID顺序建索引或新增知识点
+        } else {
+            auto it = std::lower_bound(ids.begin(), ids.end(), id);
+            if (it == ids.end() || *it != id) {
+                ids.insert(it, id);
+            }
+        }
+    }
+}
+
+void KnowledgeSearchIndex::removePoint(int id, const QString &title, const QString &content)
+{
+    QVector<quint64> grams;
+    grams.reserve(2 * (title.size() + content.size()));
+    collectGrams(title, &grams);
+    collectGrams(content, &grams);
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+
+    for (quint64 gram : std::as_const(grams)) {
+        auto posting = m_postings.find(gram);
+        if (posting == m_postings.end()) {
+            continue;
+        }
+
+        QVector<int> &ids = posting.value();
+        auto it = std::lower_bound(ids.begin(), ids.end(), id);
+        if (it != ids.end() && *it == id) {
+            ids.erase(it);
+        }
+        if (ids.isEmpty()) {
+            m_postings.erase(posting);
+        }
+    }
+}
+
+QVector<int> KnowledgeSearchIndex::candidates(const QString &query) const
+{
+    const QString folded = query.toCaseFolded();
+
+    QVector<quint64> grams;
+    if (folded.size() == 1) {
+        grams.append(unigramKey(folded.at(0).unicode()));
+    } else {
+        for (int i = 0; i + 1 < folded.size(); ++i) {
+            grams.append(bigramKey(folded.at(i).unicode(), folded.at(i + 1).unicode()));
+        }
+    }
+
+    // 从最短的列表开始求交集，其余列表用二分查找
+    QVector<const QVector<int> *> lists;
+    for (quint64 gram : std::as_const(grams)) {
+        auto posting = m_postings.constFind(gram);
+        if (posting == m_postings.constEnd()) {
+            return QVector<int>();
+        }
+        lists.append(&posting.value());
+    }
+    if (lists.isEmpty()) {
+        return QVector<int>();
+    }
+
+    std::sort(lists.begin(), lists.end(), [](const QVector<int> *a, const QVector<int> *b) {
+        return a->size() < b->size();
+    });
+    lists.erase(std::unique(lists.begin(), lists.end()), lists.end());
+
+    QVector<int> result;
+    for (int id : *lists.first()) {
+        bool inAll = true;
+        for (int i = 1; i < lists.size() && inAll; ++i) {
+            inAll = std::binary_search(lists.at(i)->begin(), lists.at(i)->end(), id);
+        }
+        if (inAll) {
+            result.append(id);
+        }
+    }
+    return result;
+}
+
+QVector<int> KnowledgeSearchIndex::matchOffsets(const QString &text, const QString &query)
+{
+    QVector<int> offsets;
+    if (query.isEmpty()) {
+        return offsets;
+    }
+
+    int from = 0;
+    while ((from = text.indexOf(query, from, Qt::CaseInsensitive)) >= 0) {
+        offsets.append(from);
+        from += query.size();
+    }
+    return offsets;
+}
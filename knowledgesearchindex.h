@@ -0,0 +1,33 @@
+#ifndef KNOWLEDGESEARCHINDEX_H
+#define KNOWLEDGESEARCHINDEX_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+// 内存中的 n-gram 倒排索引，用于实时搜索过滤，不依赖 SQLite。
+// 标题和内容按大小写折叠后的单字和双字切分（中文不需要分词），
+// 每个 gram 对应一个按ID排序的知识点列表。查询时求各列表交集得到候选，
+// 再由调用方逐个核对原文
+class KnowledgeSearchIndex
+{
+public:
+    void clear();
+
+    // 按ID递增顺序调用 addPoint 时追加到列表末尾，建索引是线性的
+    void addPoint(int id, const QString &title, const QString &content);
+    void removePoint(int id, const QString &title, const QString &content);
+
+    // 可能包含 query 的知识点ID（已排序）；query 为空时不应调用
+    QVector<int> candidates(const QString &query) const;
+
+    // text 中 query 出现的位置（不区分大小写，不重叠）
+    static QVector<int> matchOffsets(const QString &text, const QString &query);
+
+private:
+    QHash<quint64, QVector<int>> m_postings; // gram -> 排序后的知识点ID
+
+    static void collectGrams(const QString &text, QVector<quint64> *grams);
+};
+
+#endif // KNOWLEDGESEARCHINDEX_H
@@ -0,0 +1,195 @@
+#include "knowledgesnapshot.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QDebug>
+#include <cstring>
+
+// 文件布局：Header | Record × count | UTF-16 字符串区
+// 使用本机字节序，快照只是本机缓存，不跨机器使用
+static const char kMagic[8] = { 'K', 'P', 'S', 'N', 'A', 'P', '\0', '\0' };
+// 版本 2：不再保存内容和图片路径，这两项启动后按需从数据库读取
+// 版本 3：掌握程度改为有符号 16 位，“忘记”“模糊”之后可能为负
+static const quint32 kVersion = 3;
+
+struct SnapshotHeader {
+    char magic[8];
+    quint32 version;
+    quint32 count;
+    qint64 generation;
+    quint64 payloadSize;  // 记录区与字符串区的总字节数
+    quint64 checksum;     // 对负载做 FNV-1a
+};
+
+enum SnapshotString {
+    STR_TITLE,
+    STR_CATEGORY,
+    STR_COUNT
+};
+
+struct SnapshotRecord {
+    qint64 createDay;     // 儒略日，0 表示无效日期
+    qint64 lastReviewDay;
+    qint64 nextReviewDay;
+    qint32 id;
+    qint32 reviewCount;
+    quint32 stringOffset[STR_COUNT]; // 相对字符串区起点，单位为 UTF-16 字符
+    quint32 stringLength[STR_COUNT];
+    qint16 masteryLevel;
+    quint8 status;
+    quint8 reserved[5];
+};
+
+static_assert(sizeof(SnapshotHeader) == 40, "unexpected snapshot header layout");
+static_assert(sizeof(SnapshotRecord) == 56, "unexpected snapshot record layout");
+
+static quint64 fnv1a(const char *data, qint64 size, quint64 hash = 1469598103934665603ULL)
+{
+    for (qint64 i = 0; i < size; ++i) {
+        hash ^= static_cast<quint8>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static qint64 toDay(const QDate &date)
+{
+    return date.isValid() ? date.toJulianDay() : 0;
+}
+
+static QDate fromDay(qint64 day)
+{
+    return day == 0 ? QDate() : QDate::fromJulianDay(day);
+}
+
+bool KnowledgeSnapshot::read(const QString &path, qint64 generation, KnowledgePointTable *points)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const qint64 fileSize = file.size();
+    if (fileSize < qint64(sizeof(SnapshotHeader))) {
+        return false;
+    }
+
+    uchar *mapped = file.map(0, fileSize);
+    if (!mapped) {
+        qDebug() << "Snapshot map failed:" << file.errorString();
+        return false;
+    }
+
+    const char *base = reinterpret_cast<const char *>(mapped);
+    SnapshotHeader header;
+    std::memcpy(&header, base, sizeof(header));
+
+    const quint64 recordsSize = quint64(header.count) * sizeof(SnapshotRecord);
+    bool valid = std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0
+                 && header.version == kVersion
+                 && header.generation == generation
+                 && header.payloadSize == quint64(fileSize) - sizeof(header)
+                 && recordsSize <= header.payloadSize
+                 && (header.payloadSize - recordsSize) % sizeof(char16_t) == 0;
+
+    const char *payload = base + sizeof(header);
+    if (valid && fnv1a(payload, qint64(header.payloadSize)) != header.checksum) {
+        qDebug() << "Snapshot checksum mismatch";
+        valid = false;
+    }
+
+    if (!valid) {
+        file.unmap(mapped);
+        return false;
+    }
+
+    // 文件由 map() 按页对齐，记录区和字符串区都满足对齐要求
+    const SnapshotRecord *records = reinterpret_cast<const SnapshotRecord *>(payload);
+    const char16_t *strings = reinterpret_cast<const char16_t *>(payload + recordsSize);
+    const quint64 stringCount = (header.payloadSize - recordsSize) / sizeof(char16_t);
+
+    // 记录按ID递增写入，逐条追加到表尾
+    KnowledgePointTable loaded;
+    loaded.reserve(int(header.count));
+    for (quint32 i = 0; i < header.count; ++i) {
+        const SnapshotRecord &record = records[i];
+
+        QString fields[STR_COUNT];
+        for (int f = 0; f < STR_COUNT; ++f) {
+            if (quint64(record.stringOffset[f]) + record.stringLength[f] > stringCount) {
+                file.unmap(mapped);
+                return false;
+            }
+            fields[f] = QString(reinterpret_cast<const QChar *>(strings + record.stringOffset[f]),
+                                int(record.stringLength[f]));
+        }
+
+        KnowledgePoint point;
+        point.id = record.id;
+        point.title = fields[STR_TITLE];
+        point.category = fields[STR_CATEGORY];
+        point.status = static_cast<KnowledgeStatus>(record.status);
+        point.masteryLevel = record.masteryLevel;
+        point.createDate = fromDay(record.createDay);
+        point.lastReviewDate = fromDay(record.lastReviewDay);
+        point.nextReviewDate = fromDay(record.nextReviewDay);
+        point.reviewCount = record.reviewCount;
+        point.reviewtureCount = 0;
+        loaded.insert(point, false);
+    }
+
+    file.unmap(mapped);
+    *points = loaded;
+    return true;
+}
+
+bool KnowledgeSnapshot::write(const QString &path, qint64 generation, const KnowledgePointTable &points)
+{
+    QByteArray records;
+    records.reserve(points.size() * int(sizeof(SnapshotRecord)));
+    QByteArray strings;
+    quint32 stringOffset = 0;
+
+    for (int row = 0; row < points.size(); ++row) {
+        const KnowledgePoint point = points.pointAt(row);
+        SnapshotRecord record;
+        std::memset(&record, 0, sizeof(record));
+        record.createDay = toDay(point.createDate);
+        record.lastReviewDay = toDay(point.lastReviewDate);
+        record.nextReviewDay = toDay(point.nextReviewDate);
+        record.id = point.id;
+        record.reviewCount = point.reviewCount;
+        record.status = quint8(point.status);
+        record.masteryLevel = qint16(qBound(-32768, point.masteryLevel, 32767));
+
+        const QString *fields[STR_COUNT] = { &point.title, &point.category };
+        for (int f = 0; f < STR_COUNT; ++f) {
+            record.stringOffset[f] = stringOffset;
+            record.stringLength[f] = quint32(fields[f]->size());
+            strings.append(reinterpret_cast<const char *>(fields[f]->utf16()),
+                           fields[f]->size() * int(sizeof(char16_t)));
+            stringOffset += quint32(fields[f]->size());
+        }
+
+        records.append(reinterpret_cast<const char *>(&record), sizeof(record));
+    }
+
+    SnapshotHeader header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.count = quint32(points.size());
+    header.generation = generation;
+    header.payloadSize = quint64(records.size()) + quint64(strings.size());
+    header.checksum = fnv1a(strings.constData(), strings.size(),
+                            fnv1a(records.constData(), records.size()));
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "Cannot write snapshot:" << file.errorString();
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(records);
+    file.write(strings);
+    return file.commit();
+}
@@ -0,0 +1,17 @@
+#ifndef KNOWLEDGESNAPSHOT_H
+#define KNOWLEDGESNAPSHOT_H
+
+#include <QString>
+#include "knowledgepointtable.h"
+
+// 知识点的二进制快照：启动时内存映射读取，跳过 SQL 查询和 QVariant 转换。
+// 只保存列表和排程需要的字段，内容按需读取。
+// 文件带版本号、数据代数和校验和，代数与数据库不一致时视为过期
+class KnowledgeSnapshot
+{
+public:
+    static bool read(const QString &path, qint64 generation, KnowledgePointTable *points);
+    static bool write(const QString &path, qint64 generation, const KnowledgePointTable &points);
+};
+
+#endif // KNOWLEDGESNAPSHOT_H
@@ -4,9 +4,6 @@
 #include <QMessageBox>
 #include <QInputDialog>
 #include <QSettings>
-#include <QJsonDocument>
-#include <QJsonArray>
-#include <QJsonObject>
 #include <QFile>
 #include <QTextStream>
 #include <QRandomGenerator>
@@ -14,16 +11,37 @@
 #include <QFileInfo>
 #include <QPixmap>
 #include <QToolBar> // 添加 QToolBar 头文件
+#include <QStatusBar>
 #include <QSizePolicy> // 添加 QSizePolicy 头文件
 #include "imageviewerdialog.h"
+#include "knowledgepointstore.h"
+#include "knowledgeexporter.h"
+#include "knowledgeimporter.h"
+#include "knowledgelistmodel.h"
+#include "knowledgeitemdelegate.h"
+#include "knowledgecategorymodel.h"
+#include "knowledgesearchindex.h"
+#include "knowledgefiltertask.h"
+#include "imagedecodetask.h"
+#include <QThreadPool>
+#include <QTextEdit>
+#include <algorithm>
 #include <QIcon>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
+    , m_pointStore(new KnowledgePointStore(this))
+    , m_listModel(new KnowledgeListModel(m_pointStore, this))
+    , m_categoryModel(new KnowledgeCategoryModel(m_pointStore, this))
     , m_isRefreshing(false)
+    , m_filterPool(new QThreadPool(this))
+    , m_imagePool(new QThreadPool(this))
     , m_imageViewer(nullptr)
 {
+    m_filterPool->setMaxThreadCount(1); // 过滤任务依次运行，被取代的任务很快退出
+    m_filterPool->setExpiryTimeout(-1); // 线程常驻，它的只读数据库连接也就一直复用
+    m_imagePool->setMaxThreadCount(2);  // 一张大图解码时，下一张不必排在它后面
     ui->setupUi(this);
     qDebug() << "MainWindow constructed";
     // 设置窗口图标
@@ -31,12 +49,27 @@ MainWindow::MainWindow(QWidget *parent)
     this->setWindowTitle("知识点记忆系统 - 麻辣兔头");
     // 初始化图片查看器
     m_imageViewer = new ImageViewerDialog(this);
+    m_imageViewer->setImagePool(m_imagePool);
     // 设置图片标签可点击
     ui->labelImageDisplay->setCursor(Qt::PointingHandCursor);
     ui->labelImageDisplay->installEventFilter(this);
 
+    // 知识点列表：模型只保存过滤后的ID，视图只读取可见行
+    ui->listKnowledgePoints->setModel(m_listModel);
+    ui->listKnowledgePoints->setItemDelegate(new KnowledgeItemDelegate(ui->listKnowledgePoints));
+    ui->listKnowledgePoints->setUniformItemSizes(true);
+
+    // 跨过午夜后“待复习”数量会变化
+    connect(m_pointStore, &KnowledgePointStore::statisticsChanged, this, &MainWindow::updateStatistics);
+
+    // 后台保存失败时在状态栏提示，持久化线程会自动重试
+    connect(m_pointStore, &KnowledgePointStore::writeFailed, this, [this](const QString &errorMessage) {
+        statusBar()->showMessage(errorMessage, 5000);
+    });
+
     // 初始化图片存储路径
     m_imageStoragePath = getImageStoragePath();
+    m_thumbnails.setDirectory(m_imageStoragePath);
     qDebug() << "Image storage path:" << m_imageStoragePath;
     // 确保存储目录存在
     if (!ensureImageStorageDirectory()) {
@@ -58,6 +91,10 @@ MainWindow::MainWindow(QWidget *parent)
     ui->comboFilterStatus->addItem("学习中", "learning");
     ui->comboFilterStatus->addItem("复习中", "reviewing");
     ui->comboFilterStatus->addItem("已掌握", "mastered");
+    ui->comboFilterStatus->addItem("今日待复习", "due");
+
+    // 分类过滤器跟随存储的分类索引增量更新
+    ui->comboFilterCategory->setModel(m_categoryModel);
 
     // 设置图片标签
     ui->labelImageDisplay->setMinimumSize(400, 300);
@@ -67,14 +104,20 @@ MainWindow::MainWindow(QWidget *parent)
 
     // 加载数据
     loadKnowledgePoints();
-    qDebug() << "Loaded" << knowledgePoints.size() << "knowledge points";
+    qDebug() << "Loaded" << m_pointStore->size() << "knowledge points";
 
     // 如果没有数据，显示提示
-    if (knowledgePoints.isEmpty()) {
+    if (m_pointStore->isEmpty()) {
         qDebug() << "No knowledge points found, showing welcome message";
         ui->textContent->setPlainText("欢迎使用记忆曲线复习系统！\n请点击\"添加\"按钮创建第一个知识点。");
     }
 
+    // 有到期的知识点时，启动后直接列出今天要复习的内容
+    if (m_pointStore->statistics().due > 0) {
+        ui->comboFilterStatus->setCurrentIndex(ui->comboFilterStatus->findData("due"));
+        currentStatusFilter = "due";
+    }
+
     refreshKnowledgeList();
     updateStatistics();
 
@@ -87,11 +130,12 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->btnMarkReviewed, &QPushButton::clicked, this, &MainWindow::handleMarkReviewed);
     connect(ui->btnDeletePoint, &QPushButton::clicked, this, &MainWindow::handleDeletePoint);
     connect(ui->btnExportData, &QPushButton::clicked, this, &MainWindow::handleExportData);
+    connect(ui->btnImportData, &QPushButton::clicked, this, &MainWindow::handleImportData);
     connect(ui->btnClearSearch, &QPushButton::clicked, this, &MainWindow::handleClearSearch);
 
-    connect(ui->listKnowledgePoints, &QListWidget::itemSelectionChanged,
+    connect(ui->listKnowledgePoints->selectionModel(), &QItemSelectionModel::currentChanged,
             this, &MainWindow::handleListSelectionChanged);
-    connect(ui->listKnowledgePoints, &QListWidget::itemDoubleClicked,
+    connect(ui->listKnowledgePoints, &QListView::doubleClicked,
             this, &MainWindow::handleListItemDoubleClicked);
     connect(ui->editSearch, &QLineEdit::textChanged,
             this, &MainWindow::handleSearchTextChanged);
@@ -103,13 +147,40 @@ MainWindow::MainWindow(QWidget *parent)
             this, &MainWindow::handleStatusChanged);
     connect(ui->calendarReview, &QCalendarWidget::clicked,
             this, &MainWindow::handleCalendarClicked);
+    connect(ui->calendarReview, &QCalendarWidget::currentPageChanged,
+            this, &MainWindow::paintCalendarMonth);
+
+    // 单个知识点变化时只更新对应的列表行和详情
+    connect(m_pointStore, &KnowledgePointStore::pointChanged, this, &MainWindow::handlePointChanged);
+
+    // 日历热力图：到期数量变化时只重绘对应的一天
+    connect(m_pointStore, &KnowledgePointStore::dueCountChanged, this, &MainWindow::paintCalendarDay);
+    connect(m_pointStore, &KnowledgePointStore::dueCountsReset, this, [this]() {
+        paintCalendarMonth(ui->calendarReview->yearShown(), ui->calendarReview->monthShown());
+    });
+    paintCalendarMonth(ui->calendarReview->yearShown(), ui->calendarReview->monthShown());
 
     qDebug() << "MainWindow initialization completed";
 }
 
 MainWindow::~MainWindow()
 {
+    // 等待尚未完成的导出、导入线程退出
+    for (QThread *thread : {m_exportThread.data(), m_importThread.data()}) {
+        if (thread) {
+            thread->requestInterruption();
+            thread->wait();
+        }
+    }
+
+    // 作废并等待过滤和解码任务，它们引用了代数计数
+    ++m_filterGeneration;
+    ++m_imageGeneration;
+    m_filterPool->waitForDone();
+    m_imagePool->waitForDone();
+
     saveKnowledgePoints();
+    m_pointStore->writeSnapshot();
     delete m_imageViewer; // 释放图片查看器
     delete ui;
 }
@@ -165,19 +236,18 @@ void MainWindow::handleAddNew()
 
 void MainWindow::handleEditPoint()
 {
-    QListWidgetItem *currentItem = ui->listKnowledgePoints->currentItem();
-    if (!currentItem) {
+    int id = currentPointId();
+    if (id < 0) {
         QMessageBox::information(this, "提示", "请先选择一个知识点");
         return;
     }
 
-    int id = currentItem->data(Qt::UserRole).toInt();
-    if (!knowledgePoints.contains(id)) {
+    if (!m_pointStore->contains(id)) {
         QMessageBox::warning(this, "错误", "选中的知识点不存在!");
         return;
     }
 
-    const KnowledgePoint &point = knowledgePoints[id];
+    const KnowledgePoint point = m_pointStore->point(id);
 
     bool ok;
     QString title = QInputDialog::getText(this, "编辑知识点", "修改标题:",
@@ -204,6 +274,7 @@ void MainWindow::handleEditPoint()
                     oldFile.remove();
                     qDebug() << "Old image removed:" << point.imagePath;
                 }
+                ImageThumbnails::remove(point.imagePath);
             }
         }
     }
@@ -221,17 +292,16 @@ void MainWindow::handleMarkReviewed()
 {
     qDebug() << "handleMarkReviewed called";
 
-    QListWidgetItem *currentItem = ui->listKnowledgePoints->currentItem();
-    if (!currentItem) {
+    int id = currentPointId();
+    if (id < 0) {
         qDebug() << "No item selected";
         QMessageBox::warning(this, "提示", "请先选择一个知识点进行复习!");
         return;
     }
 
-    int id = currentItem->data(Qt::UserRole).toInt();
     qDebug() << "Selected item ID:" << id;
 
-    if (!knowledgePoints.contains(id)) {
+    if (!m_pointStore->contains(id)) {
         qDebug() << "Knowledge point not found for ID:" << id;
         QMessageBox::warning(this, "错误", "选中的知识点不存在!");
         return;
@@ -244,15 +314,14 @@ void MainWindow::handleMarkReviewed()
 
 void MainWindow::handleDeletePoint()
 {
-    QListWidgetItem *currentItem = ui->listKnowledgePoints->currentItem();
-    if (!currentItem) return;
+    int id = currentPointId();
+    if (id < 0) return;
 
-    int id = currentItem->data(Qt::UserRole).toInt();
     // 在删除前先获取知识点的图片文件名
     QString imageFileName;
     qDebug() << imageFileName;
-    if (knowledgePoints.contains(id)) {
-        imageFileName = knowledgePoints[id].imagePath;
+    if (m_pointStore->contains(id)) {
+        imageFileName = m_pointStore->point(id).imagePath;
     }
     if (QMessageBox::question(this, "确认删除", "确定要删除这个知识点吗?") == QMessageBox::Yes) {
         // 删除对应的图片文件
@@ -261,14 +330,17 @@ void MainWindow::handleDeletePoint()
             if (imageFile.exists()) {
                 imageFile.remove();
             }
+            ImageThumbnails::remove(imageFileName);
         }
-        knowledgePoints.remove(id);
+        m_pointStore->removePoint(id);
         saveKnowledgePoints();
         refreshKnowledgeList();
         updateStatistics();
 
         // 清空显示
         ui->textContent->clear();
+        ++m_imageGeneration; // 丢弃还在解码的图片
+        m_displayedImagePath.clear();
         ui->labelImageDisplay->setText("图片显示");
         ui->progressMastery->setValue(0);
         ui->labelMasteryPercen->setText("0%");
@@ -277,37 +349,123 @@ void MainWindow::handleDeletePoint()
 
 void MainWindow::handleExportData()
 {
+    if (m_exportThread) {
+        QMessageBox::information(this, "提示", "正在导出，请稍候");
+        return;
+    }
+
+    QString selectedFilter;
     QString fileName = QFileDialog::getSaveFileName(this, "导出数据", "",
-                                                    "JSON Files (*.json)");
+                                                    "JSON Files (*.json);;NDJSON Files (*.ndjson *.jsonl)",
+                                                    &selectedFilter);
     if (fileName.isEmpty()) return;
 
-    QJsonArray jsonArray;
-    for (const auto &point : knowledgePoints) {
-        QJsonObject jsonObject;
-        jsonObject["id"] = point.id;
-        jsonObject["title"] = point.title;
-        jsonObject["content"] = point.content;
-        jsonObject["imagePath"] = point.imagePath;
-        jsonObject["category"] = point.category;
-        jsonObject["status"] = static_cast<int>(point.status);
-        jsonObject["masteryLevel"] = point.masteryLevel;
-        jsonObject["createDate"] = point.createDate.toString(Qt::ISODate);
-        jsonObject["lastReviewDate"] = point.lastReviewDate.toString(Qt::ISODate);
-        jsonObject["nextReviewDate"] = point.nextReviewDate.toString(Qt::ISODate);
-        jsonObject["reviewCount"] = point.reviewCount;
-
-        jsonArray.append(jsonObject);
-    }
-
-    QJsonDocument doc(jsonArray);
-    QFile file(fileName);
-    if (file.open(QIODevice::WriteOnly)) {
-        file.write(doc.toJson());
-        file.close();
-        QMessageBox::information(this, "导出成功", "数据导出成功!");
+    KnowledgeExporter::Format format = KnowledgeExporter::JsonArray;
+    if (selectedFilter.startsWith("NDJSON") || fileName.endsWith(".ndjson", Qt::CaseInsensitive)
+        || fileName.endsWith(".jsonl", Qt::CaseInsensitive)) {
+        format = KnowledgeExporter::NdJson;
+    }
+
+    // 等待未保存的改动提交，导出线程直接从数据库逐行读取
+    m_pointStore->flush();
+
+    KnowledgeExporter *exporter = new KnowledgeExporter(fileName, format);
+    if (m_pointStore->usesDatabase()) {
+        exporter->setDatabasePath(m_pointStore->databasePath());
     } else {
-        QMessageBox::warning(this, "导出失败", "无法保存文件!");
+        exporter->setPoints(m_pointStore->table());
     }
+
+    QThread *thread = new QThread(this);
+    exporter->moveToThread(thread);
+    m_exportThread = thread;
+
+    connect(thread, &QThread::started, exporter, &KnowledgeExporter::run);
+    connect(exporter, &KnowledgeExporter::progress, this, [this](int exported, int total) {
+        statusBar()->showMessage(QString("正在导出：%1/%2").arg(exported).arg(total));
+    });
+    connect(exporter, &KnowledgeExporter::finished, this, [this](bool ok, const QString &errorMessage) {
+        statusBar()->clearMessage();
+        ui->btnExportData->setEnabled(true);
+        if (ok) {
+            QMessageBox::information(this, "导出成功", "数据导出成功!");
+        } else {
+            QMessageBox::warning(this, "导出失败", QString("无法保存文件: %1").arg(errorMessage));
+        }
+    });
+    connect(exporter, &KnowledgeExporter::finished, thread, &QThread::quit);
+    connect(thread, &QThread::finished, exporter, &QObject::deleteLater);
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+
+    ui->btnExportData->setEnabled(false);
+    thread->start();
+}
+
+void MainWindow::handleImportData()
+{
+    if (m_importThread) {
+        QMessageBox::information(this, "提示", "正在导入，请稍候");
+        return;
+    }
+
+    if (!m_pointStore->usesDatabase()) {
+        QMessageBox::warning(this, "导入失败", "数据库不可用，无法导入");
+        return;
+    }
+
+    QString fileName = QFileDialog::getOpenFileName(this, "导入数据", "",
+                                                    "JSON Files (*.json *.ndjson *.jsonl)");
+    if (fileName.isEmpty()) return;
+
+    // 等待未保存的改动提交，导入完成后从数据库重新加载
+    m_pointStore->flush();
+
+    KnowledgeImporter *importer = new KnowledgeImporter(fileName, m_pointStore->databasePath());
+    QThread *thread = new QThread(this);
+    importer->moveToThread(thread);
+    m_importThread = thread;
+
+    connect(thread, &QThread::started, importer, &KnowledgeImporter::run);
+    connect(importer, &KnowledgeImporter::progress, this, [this](int imported) {
+        statusBar()->showMessage(QString("正在导入：%1").arg(imported));
+    });
+    connect(importer, &KnowledgeImporter::finished, this,
+            [this](bool ok, int imported, const QString &errorMessage) {
+        statusBar()->clearMessage();
+        ui->btnImportData->setEnabled(true);
+        setEditingEnabled(true);
+
+        if (imported > 0) {
+            // 重新加载后下一个ID从数据库里最大的ID之后分配
+            saveKnowledgePoints();
+            loadKnowledgePoints();
+            refreshKnowledgeList();
+            updateStatistics();
+        }
+
+        if (ok) {
+            QMessageBox::information(this, "导入成功", QString("成功导入 %1 个知识点").arg(imported));
+        } else {
+            QMessageBox::warning(this, "导入失败",
+                                 QString("%1（已导入 %2 个知识点）").arg(errorMessage).arg(imported));
+        }
+    });
+    connect(importer, &KnowledgeImporter::finished, thread, &QThread::quit);
+    connect(thread, &QThread::finished, importer, &QObject::deleteLater);
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+
+    ui->btnImportData->setEnabled(false);
+    setEditingEnabled(false);
+    thread->start();
+}
+
+void MainWindow::setEditingEnabled(bool enabled)
+{
+    // 导入时数据库自动分配ID，存储里的下一个ID可能与导入的行重复，
+    // 此时新增的知识点会覆盖导入的知识点，所以导入完成前不允许增删改
+    ui->btnAddNew->setEnabled(enabled);
+    ui->btnEditPoint->setEnabled(enabled);
+    ui->btnDeletePoint->setEnabled(enabled);
 }
 
 void MainWindow::handleClearSearch()
@@ -343,11 +501,13 @@ void MainWindow::handleListSelectionChanged()
 
     qDebug() << "handleListSelectionChanged called";
 
-    QListWidgetItem *currentItem = ui->listKnowledgePoints->currentItem();
-    if (!currentItem) {
+    int id = currentPointId();
+    if (id < 0) {
         qDebug() << "No item selected";
         // 清空显示，避免显示无效数据
         ui->textContent->clear();
+        ++m_imageGeneration; // 丢弃还在解码的图片
+        m_displayedImagePath.clear();
         ui->labelImageDisplay->setText("图片显示");
         ui->progressMastery->setValue(0);
         ui->labelMasteryPercen->setText("0%");
@@ -357,7 +517,6 @@ void MainWindow::handleListSelectionChanged()
         return;
     }
 
-    int id = currentItem->data(Qt::UserRole).toInt();
     qDebug() << "Selected item ID:" << id;
 
     showKnowledgePointDetails(id);
@@ -368,9 +527,9 @@ void MainWindow::handleListSelectionChanged()
     qDebug() << "handleListSelectionChanged completed";
 }
 
-void MainWindow::handleListItemDoubleClicked(QListWidgetItem *item)
+void MainWindow::handleListItemDoubleClicked(const QModelIndex &index)
 {
-    Q_UNUSED(item);
+    Q_UNUSED(index);
     handleMarkReviewed();
 }
 
@@ -378,6 +537,27 @@ void MainWindow::handleSearchTextChanged(const QString &text)
 {
     currentSearchText = text;
     filterKnowledgePoints();
+    highlightSearchMatches();
+}
+
+void MainWindow::highlightSearchMatches()
+{
+    // 用额外选区标出搜索词，不修改文档内容
+    QList<QTextEdit::ExtraSelection> selections;
+    QTextCharFormat format;
+    format.setBackground(QColor(255, 230, 0));
+
+    const QVector<int> offsets = KnowledgeSearchIndex::matchOffsets(ui->textContent->toPlainText(),
+                                                                    currentSearchText);
+    for (int offset : offsets) {
+        QTextEdit::ExtraSelection selection;
+        selection.cursor = QTextCursor(ui->textContent->document());
+        selection.cursor.setPosition(offset);
+        selection.cursor.setPosition(offset + currentSearchText.size(), QTextCursor::KeepAnchor);
+        selection.format = format;
+        selections.append(selection);
+    }
+    ui->textContent->setExtraSelections(selections);
 }
 
 void MainWindow::handleFilterCategoryChanged(int index)
@@ -396,14 +576,13 @@ void MainWindow::handleStatusChanged(int index)
 {
     qDebug() << "handleStatusChanged called with index:" << index;
 
-    QListWidgetItem *currentItem = ui->listKnowledgePoints->currentItem();
-    if (!currentItem) {
+    int id = currentPointId();
+    if (id < 0) {
         qDebug() << "No item selected, ignoring status change";
         return;
     }
 
-    int id = currentItem->data(Qt::UserRole).toInt();
-    if (!knowledgePoints.contains(id)) {
+    if (!m_pointStore->contains(id)) {
         qDebug() << "Knowledge point not found for ID:" << id;
         return;
     }
@@ -414,295 +593,244 @@ void MainWindow::handleStatusChanged(int index)
         return;
     }
 
-    KnowledgePoint &point = knowledgePoints[id];
+    KnowledgePoint point = m_pointStore->point(id);
     KnowledgeStatus newStatus = static_cast<KnowledgeStatus>(ui->comboStatus->itemData(index).toInt());
 
     qDebug() << "Changing status from" << point.status << "to" << newStatus;
 
     point.status = newStatus;
+    m_pointStore->updatePoint(point); // 通过 pointChanged 只更新这一行
 
     saveKnowledgePoints();
-    refreshKnowledgeList();
-    updateStatistics();
 
     qDebug() << "Status change completed";
 }
 
 void MainWindow::handleCalendarClicked(const QDate &date)
 {
-    // 高亮显示需要复习的日期
-    QTextCharFormat format;
-    format.setBackground(Qt::yellow);
+    // 颜色已由热力图绘制，这里只提示当天的复习量
+    statusBar()->showMessage(QString("%1 待复习：%2")
+                                 .arg(date.toString("yyyy-MM-dd"))
+                                 .arg(m_pointStore->dueCountOn(date)), 5000);
+}
 
-    for (const auto &point : knowledgePoints) {
-        if (point.nextReviewDate == date && point.status != STATUS_MASTERED) {
-            ui->calendarReview->setDateTextFormat(date, format);
-        }
+void MainWindow::paintCalendarMonth(int year, int month)
+{
+    // 切换月份时清除旧的格式，只读取直方图，不遍历知识点
+    ui->calendarReview->setDateTextFormat(QDate(), QTextCharFormat());
+
+    // 日历页会显示前后月份的几天
+    const QDate first(year, month, 1);
+    const QDate last = first.addDays(first.daysInMonth() - 1);
+    for (QDate date = first.addDays(-7); date <= last.addDays(14); date = date.addDays(1)) {
+        paintCalendarDay(date);
     }
 }
 
-void MainWindow::loadKnowledgePoints()
+void MainWindow::paintCalendarDay(const QDate &date)
 {
-    qDebug() << "Loading knowledge points...";
-
-    QSettings settings("MyCompany", "KnowledgeReview");
-
-    qDebug() << "设置文件路径:" << settings.fileName();
-    qDebug() << "组织名称:" << settings.organizationName();
-    qDebug() << "应用名称:" << settings.applicationName();
-
-    // 列出所有现有的键
-    qDebug() << "所有配置键:";
-    foreach (QString key, settings.allKeys()) {
-        qDebug() << key << ":" << settings.value(key).toString();
+    // 只绘制当前可见的一页
+    const QDate first(ui->calendarReview->yearShown(), ui->calendarReview->monthShown(), 1);
+    if (date < first.addDays(-7) || date > first.addDays(first.daysInMonth() + 13)) {
+        return;
     }
 
-    int count = settings.value("knowledgeCount", 0).toInt();
-    qDebug() << "Found" << count << "knowledge points in settings";
-
-    knowledgePoints.clear();
-    nextId = 1;
-
-    for (int i = 0; i < count; ++i) {
-        QString prefix = QString("point_%1_").arg(i);
-
-        // 检查必要的键是否存在
-        if (!settings.contains(prefix + "id") ||
-            !settings.contains(prefix + "title")) {
-            qDebug() << "Skipping invalid entry at index" << i;
-            continue;
-        }
-
-        KnowledgePoint point;
-        point.id = settings.value(prefix + "id").toInt();
-        point.title = settings.value(prefix + "title").toString();
-        point.content = settings.value(prefix + "content").toString();
-        point.imagePath = settings.value(prefix + "imagePath").toString();
-        point.category = settings.value(prefix + "category").toString();
-        point.status = static_cast<KnowledgeStatus>(settings.value(prefix + "status").toInt());
-        point.masteryLevel = settings.value(prefix + "masteryLevel").toInt();
-        point.createDate = settings.value(prefix + "createDate").toDate();
-        point.lastReviewDate = settings.value(prefix + "lastReviewDate").toDate();
-        point.nextReviewDate = settings.value(prefix + "nextReviewDate").toDate();
-        point.reviewCount = settings.value(prefix + "reviewCount").toInt();
-
-        // 验证数据有效性
-        if (point.id <= 0 || point.title.isEmpty()) {
-            qDebug() << "Skipping invalid knowledge point:" << point.id << point.title;
-            continue;
-        }
-
-        knowledgePoints[point.id] = point;
-        if (point.id >= nextId) nextId = point.id + 1;
-
-        qDebug() << "Loaded point:" << point.id << point.title;
+    const int count = m_pointStore->dueCountOn(date);
+    QTextCharFormat format;
+    if (count > 0) {
+        // 到期越多颜色越深：浅黄到橙红，超过 kHeatmapFull 个按最深处理
+        static const int kHeatmapFull = 20;
+        const double t = double(qMin(count, kHeatmapFull)) / kHeatmapFull;
+        format.setBackground(QColor(255, int(240 - 130 * t), int(170 - 110 * t)));
+        format.setToolTip(QString("待复习：%1").arg(count));
     }
+    ui->calendarReview->setDateTextFormat(date, format);
+}
 
-    qDebug() << "Total loaded:" << knowledgePoints.size() << "valid knowledge points";
+void MainWindow::loadKnowledgePoints()
+{
+    m_pointStore->load();
 }
 
 void MainWindow::saveKnowledgePoints()
 {
-    qDebug() << "Saving" << knowledgePoints.size() << "knowledge points...";
-
     // 阻塞所有可能触发刷新的信号
-    bool oldListState = ui->listKnowledgePoints->blockSignals(true);
+    bool oldListState = ui->listKnowledgePoints->selectionModel()->blockSignals(true);
     bool oldComboState = ui->comboStatus->blockSignals(true);
 
-    QSettings settings("MyCompany", "KnowledgeReview");
-
-    // 将知识点列表按下次复习时间排序（由近到远）
-    QList<KnowledgePoint> sortedPoints = knowledgePoints.values();
-
-    // 使用稳定排序，按下次复习时间升序排列（最近的在前）
-    std::sort(sortedPoints.begin(), sortedPoints.end(),
-              [](const KnowledgePoint &a, const KnowledgePoint &b) {
-                  return a.nextReviewDate < b.nextReviewDate;
-              });
-
-    // 保存排序后的知识点数量
-    settings.setValue("knowledgeCount", sortedPoints.size());
-
-    int index = 0;
-    for (const auto &point : sortedPoints) {
-        QString prefix = QString("point_%1_").arg(index);
-
-        settings.setValue(prefix + "id", point.id);
-        settings.setValue(prefix + "title", point.title);
-        settings.setValue(prefix + "content", point.content);
-        settings.setValue(prefix + "imagePath", point.imagePath);
-        settings.setValue(prefix + "category", point.category);
-        settings.setValue(prefix + "status", static_cast<int>(point.status));
-        settings.setValue(prefix + "masteryLevel", point.masteryLevel);
-        settings.setValue(prefix + "createDate", point.createDate);
-        settings.setValue(prefix + "lastReviewDate", point.lastReviewDate);
-        settings.setValue(prefix + "nextReviewDate", point.nextReviewDate);
-        settings.setValue(prefix + "reviewCount", point.reviewCount);
-
-        qDebug() << "Saved point:" << point.id << point.title;
-        index++;
-    }
-
-    settings.sync(); // 确保数据写入磁盘
+    // 只写入新增、修改和删除过的知识点
+    m_pointStore->save();
 
     // 恢复信号状态
-    ui->listKnowledgePoints->blockSignals(oldListState);
+    ui->listKnowledgePoints->selectionModel()->blockSignals(oldListState);
     ui->comboStatus->blockSignals(oldComboState);
+}
 
-    qDebug() << "Data saved successfully, software continues to run";
+// 状态过滤器的数据转换为状态值，不按状态过滤时返回 -1
+static int statusFromFilter(const QString &filter)
+{
+    if (filter == "new") return STATUS_NEW;
+    if (filter == "learning") return STATUS_LEARNING;
+    if (filter == "reviewing") return STATUS_REVIEWING;
+    if (filter == "mastered") return STATUS_MASTERED;
+    return -1;
 }
 
 void MainWindow::refreshKnowledgeList()
 {
-    if (m_isRefreshing) {
-        qDebug() << "Already refreshing, skipping recursive call";
-        return;
+    // 新的请求使正在运行的过滤任务作废，输入框每次按键都不会阻塞界面
+    const int generation = ++m_filterGeneration;
+
+    KnowledgeFilter filter;
+    filter.searchText = currentSearchText;
+    filter.category = currentCategoryFilter;
+    filter.status = statusFromFilter(currentStatusFilter);
+    filter.dueOnly = currentStatusFilter == "due";
+
+    // 任务拿到的是表格和索引的隐式共享副本，提交时只增加引用计数
+    KnowledgeFilterTask *task = new KnowledgeFilterTask(filter, generation, &m_filterGeneration);
+    task->setTable(m_pointStore->table());
+    if (!filter.searchText.isEmpty()) {
+        m_pointStore->prepareSearchIndex();
+        if (m_pointStore->hasSearchIndex()) {
+            task->setSearchIndex(m_pointStore->searchIndex());
+        }
+    }
+    if (filter.dueOnly) {
+        // 今日待复习：到期部分从复习日期索引取出，只遍历到期的前缀
+        task->setDueIds(m_pointStore->dueIds(QDate::currentDate()));
+    }
+    if (m_pointStore->usesDatabase()) {
+        task->setDatabasePath(m_pointStore->databasePath());
+    }
+    task->setResultHandler(this, [this](int resultGeneration, const QVector<int> &ids) {
+        applyFilterResult(resultGeneration, ids);
+    });
+    m_filterPool->start(task);
+}
+
+void MainWindow::applyFilterResult(int generation, const QVector<int> &ids)
+{
+    if (generation != m_filterGeneration) {
+        return; // 已有更新的过滤请求
     }
 
     m_isRefreshing = true;
-    qDebug() << "refreshKnowledgeList called";
 
     // 阻塞信号，防止触发选择变化事件
-    bool oldState = ui->listKnowledgePoints->blockSignals(true);
+    QItemSelectionModel *selection = ui->listKnowledgePoints->selectionModel();
+    bool oldState = selection->blockSignals(true);
 
     // 保存当前选中的项目
-    QListWidgetItem *currentItem = ui->listKnowledgePoints->currentItem();
-    int currentId = -1;
-    if (currentItem) {
-        currentId = currentItem->data(Qt::UserRole).toInt();
-    }
+    int currentId = currentPointId();
 
-    ui->listKnowledgePoints->clear();
-    qDebug() << "List cleared";
+    // 一次换入整个结果，模型只重置一次
+    m_listModel->setIds(ids);
+    m_listedGeneration = generation;
+    qDebug() << "Added" << ids.size() << "items to list";
 
-    // 获取所有分类并更新过滤器
-    QSet<QString> categories;
-    ui->comboFilterCategory->clear();
-    ui->comboFilterCategory->addItem("全部分类", "");
-
-    for (const auto &point : knowledgePoints) {
-        if (!point.category.isEmpty() && !categories.contains(point.category)) {
-            categories.insert(point.category);
-            ui->comboFilterCategory->addItem(point.category, point.category);
-        }
+    // 恢复选中状态
+    int selectedRow = m_listModel->rowOf(currentId);
+    if (selectedRow >= 0) {
+        selection->setCurrentIndex(m_listModel->index(selectedRow), QItemSelectionModel::ClearAndSelect);
+        ui->listKnowledgePoints->scrollTo(m_listModel->index(selectedRow));
+        qDebug() << "Restored selection to item ID:" << currentId;
+    } else if (m_listModel->rowCount() > 0) {
+        // 如果没有匹配的选中项目，选择第一个
+        selection->setCurrentIndex(m_listModel->index(0), QItemSelectionModel::ClearAndSelect);
+        qDebug() << "Auto-selected first item";
     }
-    qDebug() << "Categories updated:" << categories.size();
 
-    // 添加知识点到列表
-    int addedCount = 0;
-    QListWidgetItem *selectedItem = nullptr;
+    // 恢复信号
+    selection->blockSignals(oldState);
 
-    for (const auto &point : knowledgePoints) {
-        // 应用过滤器
-        if (!currentSearchText.isEmpty() &&
-            !point.title.contains(currentSearchText, Qt::CaseInsensitive) &&
-            !point.content.contains(currentSearchText, Qt::CaseInsensitive)) {
-            continue;
-        }
+    m_isRefreshing = false;
+}
 
-        if (!currentCategoryFilter.isEmpty() && point.category != currentCategoryFilter) {
-            continue;
-        }
+bool MainWindow::matchesFilter(const KnowledgePoint &point) const
+{
+    // 应用过滤器
+    if (!currentSearchText.isEmpty() &&
+        !point.title.contains(currentSearchText, Qt::CaseInsensitive) &&
+        !point.content.contains(currentSearchText, Qt::CaseInsensitive)) {
+        return false;
+    }
 
-        if (!currentStatusFilter.isEmpty()) {
-            QString statusStr;
-            switch (point.status) {
-            case STATUS_NEW: statusStr = "new"; break;
-            case STATUS_LEARNING: statusStr = "learning"; break;
-            case STATUS_REVIEWING: statusStr = "reviewing"; break;
-            case STATUS_MASTERED: statusStr = "mastered"; break;
-            }
-            if (statusStr != currentStatusFilter) continue;
-        }
+    if (!currentCategoryFilter.isEmpty() && point.category != currentCategoryFilter) {
+        return false;
+    }
 
-        QListWidgetItem *item = new QListWidgetItem(point.title);
-        item->setData(Qt::UserRole, point.id);
-
-        // 根据状态设置颜色
-        switch (point.status) {
-        case STATUS_NEW:
-            item->setBackground(Qt::lightGray);
-            break;
-        case STATUS_LEARNING:
-            item->setBackground(QColor(255, 255, 200)); // 浅黄色
-            break;
-        case STATUS_REVIEWING:
-            if (point.nextReviewDate <= QDate::currentDate()) {
-                item->setBackground(QColor(255, 200, 200)); // 浅红色（需要复习）
-            } else {
-                item->setBackground(QColor(200, 255, 200)); // 浅绿色
-            }
-            break;
-        case STATUS_MASTERED:
-            item->setBackground(Qt::cyan);
-            break;
-        }
+    if (currentStatusFilter == "due") {
+        return KnowledgePointStore::isDue(point, QDate::currentDate());
+    }
 
-        ui->listKnowledgePoints->addItem(item);
-        addedCount++;
+    const int status = statusFromFilter(currentStatusFilter);
+    return status < 0 || point.status == status;
+}
+
+void MainWindow::handlePointChanged(int id, KnowledgePointFields fields)
+{
+    const KnowledgePoint point = m_pointStore->point(id);
 
-        // 记录需要选中的项目
-        if (point.id == currentId) {
-            selectedItem = item;
+    if (m_listedGeneration != m_filterGeneration) {
+        // 正在进行的过滤基于修改前的副本，重新过滤，详情照常更新
+        refreshKnowledgeList();
+        if (id == currentPointId()) {
+            showKnowledgePointDetails(point, fields);
         }
+        return;
     }
+    const bool listed = m_listModel->rowOf(id) >= 0;
+    const bool matches = matchesFilter(point);
 
-    qDebug() << "Added" << addedCount << "items to list";
+    if (listed && !matches) {
+        // 不再符合过滤条件（例如复习后不再到期）：只移除这一行，
+        // 选择模型会把当前行移到下一张卡片
+        m_listModel->removePoint(id);
+        return;
+    }
 
-    // 恢复选中状态
-    if (selectedItem) {
-        selectedItem->setSelected(true);
-        ui->listKnowledgePoints->setCurrentItem(selectedItem);
-        qDebug() << "Restored selection to item ID:" << currentId;
-    } else if (ui->listKnowledgePoints->count() > 0) {
-        // 如果没有匹配的选中项目，选择第一个
-        ui->listKnowledgePoints->setCurrentRow(0);
-        qDebug() << "Auto-selected first item";
+    if (!listed && matches) {
+        // 新符合条件的知识点需要按列表顺序插入，少见，整体刷新
+        refreshKnowledgeList();
+        return;
     }
 
-    // 恢复信号
-    ui->listKnowledgePoints->blockSignals(oldState);
+    if (listed) {
+        m_listModel->refreshPoint(id);
+    }
 
-    qDebug() << "refreshKnowledgeList completed";
+    if (id == currentPointId()) {
+        showKnowledgePointDetails(point, fields);
+    }
+}
 
-    m_isRefreshing = false;
-    qDebug() << "refreshKnowledgeList completed";
+int MainWindow::currentPointId() const
+{
+    return m_listModel->idAt(ui->listKnowledgePoints->currentIndex().row());
 }
 
 void MainWindow::updateStatistics()
 {
-    qDebug() << "updateStatistics called";
+    // 计数由存储增量维护，这里只更新标签
+    const KnowledgeStatistics &stats = m_pointStore->statistics();
 
-    int total = knowledgePoints.size();
-    int due = 0;
-    int learning = 0;
-    int mastered = 0;
-
-    QDate today = QDate::currentDate();
-
-    for (const auto &point : knowledgePoints) {
-        if (point.status == STATUS_LEARNING) learning++;
-        else if (point.status == STATUS_MASTERED) mastered++;
-        else if (point.status == STATUS_REVIEWING && point.nextReviewDate <= today) due++;
-    }
-
-    ui->labelStatsTotal->setText(QString("总计：%1").arg(total));
-    ui->labelStatsDue->setText(QString("待复习：%1").arg(due));
-    ui->label_3->setText(QString("学习中：%1").arg(learning));
-    ui->label_4->setText(QString("已掌握：%1").arg(mastered));
-
-    qDebug() << "Statistics: Total:" << total << "Due:" << due << "Learning:" << learning << "Mastered:" << mastered;
-    qDebug() << "updateStatistics completed";
+    ui->labelStatsTotal->setText(QString("总计：%1").arg(stats.total));
+    ui->labelStatsDue->setText(QString("待复习：%1").arg(stats.due));
+    ui->label_3->setText(QString("学习中：%1").arg(stats.learning));
+    ui->label_4->setText(QString("已掌握：%1").arg(stats.mastered));
 }
 
 void MainWindow::showKnowledgePointDetails(int id)
 {
     qDebug() << "showKnowledgePointDetails called with ID:" << id;
 
-    if (!knowledgePoints.contains(id)) {
+    if (!m_pointStore->contains(id)) {
         qDebug() << "Error: Knowledge point not found in showDetails!";
         // 清空显示，避免显示无效数据
         ui->textContent->clear();
+        ++m_imageGeneration; // 丢弃还在解码的图片
+        m_displayedImagePath.clear();
         ui->labelImageDisplay->setText("无数据");
         ui->progressMastery->setValue(0);
         ui->labelMasteryPercen->setText("0%");
@@ -711,42 +839,49 @@ void MainWindow::showKnowledgePointDetails(int id)
         return;
     }
 
-    const KnowledgePoint &point = knowledgePoints[id];
+    const KnowledgePoint point = m_pointStore->point(id);
     qDebug() << "Showing details for:" << point.title;
 
-    // 显示基本信息
-    ui->textContent->setPlainText(point.content);
+    showKnowledgePointDetails(point, FIELD_ALL);
 
-    // 显示图片
-    displayImage(point.imagePath);
+    qDebug() << "Details shown successfully";
+}
 
-    // 显示掌握程度
-    ui->progressMastery->setValue(point.masteryLevel);
-    ui->labelMasteryPercen->setText(QString("%1%").arg(point.masteryLevel));
+void MainWindow::showKnowledgePointDetails(const KnowledgePoint &point, KnowledgePointFields fields)
+{
+    // 只更新发生变化的部分，复习后不必重新加载图片
+    if (fields & FIELD_CONTENT) {
+        // 显示基本信息
+        ui->textContent->setPlainText(point.content);
+        highlightSearchMatches();
+    }
 
-    // 显示状态 - 阻塞信号避免递归
-    bool oldState = ui->comboStatus->blockSignals(true);
-    int statusIndex = -1;
-    for (int i = 0; i < ui->comboStatus->count(); ++i) {
-        if (ui->comboStatus->itemData(i).toInt() == static_cast<int>(point.status)) {
-            statusIndex = i;
-            break;
-        }
+    if (fields & FIELD_IMAGE) {
+        // 显示图片
+        displayImage(point.imagePath);
     }
-    if (statusIndex >= 0) {
-        ui->comboStatus->setCurrentIndex(statusIndex);
-    } else {
-        ui->comboStatus->setCurrentIndex(0);
+
+    if (fields & FIELD_MASTERY) {
+        // 显示掌握程度
+        ui->progressMastery->setValue(point.masteryLevel);
+        ui->labelMasteryPercen->setText(QString("%1%").arg(point.masteryLevel));
     }
-    ui->comboStatus->blockSignals(oldState);
 
-    // 显示复习时间
-    ui->labelLastReviewValue->setText(point.lastReviewDate.isValid() ?
-                                          point.lastReviewDate.toString("yyyy-MM-dd") : "从未复习");
-    ui->labelNextReviewValue->setText(point.nextReviewDate.isValid() ?
-                                          point.nextReviewDate.toString("yyyy-MM-dd") : "未设置");
+    if (fields & FIELD_STATUS) {
+        // 显示状态 - 阻塞信号避免递归
+        bool oldState = ui->comboStatus->blockSignals(true);
+        int statusIndex = ui->comboStatus->findData(static_cast<int>(point.status));
+        ui->comboStatus->setCurrentIndex(statusIndex >= 0 ? statusIndex : 0);
+        ui->comboStatus->blockSignals(oldState);
+    }
 
-    qDebug() << "Details shown successfully";
+    if (fields & FIELD_REVIEW_DATES) {
+        // 显示复习时间
+        ui->labelLastReviewValue->setText(point.lastReviewDate.isValid() ?
+                                              point.lastReviewDate.toString("yyyy-MM-dd") : "从未复习");
+        ui->labelNextReviewValue->setText(point.nextReviewDate.isValid() ?
+                                              point.nextReviewDate.toString("yyyy-MM-dd") : "未设置");
+    }
 }
 
 void MainWindow::addKnowledgePoint(const QString &title, const QString &content,
@@ -761,7 +896,6 @@ void MainWindow::addKnowledgePoint(const QString &title, const QString &content,
     }
 
     KnowledgePoint point;
-    point.id = nextId++;
     point.title = title;
     point.content = content;
     point.imagePath = imagePath;
@@ -772,9 +906,10 @@ void MainWindow::addKnowledgePoint(const QString &title, const QString &content,
     point.lastReviewDate = QDate();
     point.nextReviewDate = QDate::currentDate().addDays(1);
     point.reviewCount = 0;
+    point.reviewtureCount = 0;
 
-    knowledgePoints[point.id] = point;
-    qDebug() << "Point added to map, ID:" << point.id << "Total points now:" << knowledgePoints.size();
+    point.id = m_pointStore->addPoint(point);
+    qDebug() << "Point added to store, ID:" << point.id << "Total points now:" << m_pointStore->size();
 
     // 立即保存数据
     saveKnowledgePoints();
@@ -793,29 +928,29 @@ void MainWindow::addKnowledgePoint(const QString &title, const QString &content,
 void MainWindow::editKnowledgePoint(int id, const QString &title, const QString &content,
                                     const QString &imagePath, const QString &category)
 {
-    if (!knowledgePoints.contains(id)) return;
+    if (!m_pointStore->contains(id)) return;
 
-    KnowledgePoint &point = knowledgePoints[id];
+    KnowledgePoint point = m_pointStore->point(id);
     point.title = title;
     point.content = content;
     point.imagePath = imagePath;
     point.category = category;
+    m_pointStore->updatePoint(point); // 通过 pointChanged 只更新这一行和详情
 
     // 不再立即保存
-    refreshKnowledgeList();
-    showKnowledgePointDetails(id);
 }
 
 void MainWindow::markAsReviewed(int id,int reviewvalue)
 {
     qDebug() << "markAsReviewed called with ID:" << id;
 
-    if (!knowledgePoints.contains(id)) {
+    if (!m_pointStore->contains(id)) {
         qDebug() << "Error: Knowledge point not found!";
         return;
     }
 
-    KnowledgePoint &point = knowledgePoints[id];
+    // 复习只改排程字段，不需要读取内容
+    KnowledgePoint point = m_pointStore->table().point(id);
     qDebug() << "Before review - Mastery:" << point.masteryLevel << "Review count:" << point.reviewCount;
 
     point.lastReviewDate = QDate::currentDate();
@@ -847,20 +982,10 @@ void MainWindow::markAsReviewed(int id,int reviewvalue)
         qDebug() << "Status changed to LEARNING";
     }
 
-    // 立即保存数据
-    saveKnowledgePoints();
-    qDebug() << "Data saved";
-
-    // 只刷新一次，避免递归
-    refreshKnowledgeList();
-    qDebug() << "List refreshed";
-
-    updateStatistics();
-    qDebug() << "Statistics updated";
-
-    // 显示详细信息
-    showKnowledgePointDetails(id);
-    qDebug() << "Details shown";
+    // 只追加一条复习日志，由存储在后台合并进数据库。
+    // 列表行、统计和详情由 pointChanged/statisticsChanged 只更新受影响的部分
+    m_pointStore->recordReview(point, reviewvalue);
+    qDebug() << "Review journaled";
 
     qDebug() << "markAsReviewed completed";
 }
@@ -893,9 +1018,9 @@ QDate MainWindow::calculateNextReviewDate(int currentLevel, int reviewCount)
 
 void MainWindow::updateMasteryLevel(int id, int newLevel)
 {
-    if (!knowledgePoints.contains(id)) return;
+    if (!m_pointStore->contains(id)) return;
 
-    KnowledgePoint &point = knowledgePoints[id];
+    KnowledgePoint point = m_pointStore->point(id);
     point.masteryLevel = newLevel;
 
     // 更新状态
@@ -906,10 +1031,9 @@ void MainWindow::updateMasteryLevel(int id, int newLevel)
     } else {
         point.status = STATUS_LEARNING;
     }
+    m_pointStore->updatePoint(point); // 通过 pointChanged 只更新这一行
 
     saveKnowledgePoints();
-    refreshKnowledgeList();
-    updateStatistics();
 }
 
 void MainWindow::filterKnowledgePoints()
@@ -920,40 +1044,46 @@ void MainWindow::filterKnowledgePoints()
 
 void MainWindow::displayImage(const QString &imagePath)
 {
-    ui->labelImageDisplay->clear();
-
-    if (!imagePath.isEmpty()) {
-        QFileInfo fileInfo(imagePath);
-        if (fileInfo.exists() && fileInfo.isFile()) {
-            QPixmap pixmap(imagePath);
-            if (!pixmap.isNull()) {
-                // 应用缩放因子
-                QSize scaledSize = pixmap.size() * imageZoomFactor;
-                QPixmap scaledPixmap = pixmap.scaled(scaledSize,
-                                                     Qt::KeepAspectRatio,
-                                                     Qt::SmoothTransformation);
-                ui->labelImageDisplay->setPixmap(scaledPixmap);
-                return;
-            } else {
-                ui->labelImageDisplay->setText("图片加载失败");
-            }
-        } else {
-            ui->labelImageDisplay->setText("图片文件不存在");
-        }
-    } else {
+    // 新的请求使还在排队或解码中的图片作废，只有最后选中的图片会显示
+    const int generation = ++m_imageGeneration;
+
+    if (imagePath.isEmpty()) {
+        m_displayedImagePath.clear();
+        ui->labelImageDisplay->clear();
         ui->labelImageDisplay->setText("无图片");
+        return;
+    }
+
+    // 换了图片才显示占位文字；同一张图片缩放时旧图留在原处，避免闪烁
+    if (imagePath != m_displayedImagePath) {
+        m_displayedImagePath.clear();
+        ui->labelImageDisplay->clear();
+        ui->labelImageDisplay->setText("图片加载中...");
     }
+
+    ImageDecodeTask *task = new ImageDecodeTask(imagePath, ui->labelImageDisplay->size(), imageZoomFactor,
+                                                m_thumbnails, &m_imageCache, generation, &m_imageGeneration);
+    task->setResultHandler(this, [this, imagePath](int resultGeneration, const QImage &image, const QString &errorMessage) {
+        if (resultGeneration != m_imageGeneration) {
+            return;
+        }
+        if (image.isNull()) {
+            m_displayedImagePath.clear();
+            ui->labelImageDisplay->setText(errorMessage);
+        } else {
+            m_displayedImagePath = imagePath;
+            ui->labelImageDisplay->setPixmap(QPixmap::fromImage(image));
+        }
+    });
+    m_imagePool->start(task);
 }
 
 void MainWindow::handleZoomIn()
 {
     imageZoomFactor *= 1.2;
-    QListWidgetItem *currentItem = ui->listKnowledgePoints->currentItem();
-    if (currentItem) {
-        int id = currentItem->data(Qt::UserRole).toInt();
-        if (knowledgePoints.contains(id)) {
-            displayImage(knowledgePoints[id].imagePath);
-        }
+    int id = currentPointId();
+    if (m_pointStore->contains(id)) {
+        displayImage(m_pointStore->point(id).imagePath);
     }
 }
 
@@ -962,24 +1092,18 @@ void MainWindow::handleZoomOut()
     imageZoomFactor /= 1.2;
     if (imageZoomFactor < 0.1) imageZoomFactor = 0.1;
 
-    QListWidgetItem *currentItem = ui->listKnowledgePoints->currentItem();
-    if (currentItem) {
-        int id = currentItem->data(Qt::UserRole).toInt();
-        if (knowledgePoints.contains(id)) {
-            displayImage(knowledgePoints[id].imagePath);
-        }
+    int id = currentPointId();
+    if (m_pointStore->contains(id)) {
+        displayImage(m_pointStore->point(id).imagePath);
     }
 }
 
 void MainWindow::handleResetZoom()
 {
     imageZoomFactor = 1.0;
-    QListWidgetItem *currentItem = ui->listKnowledgePoints->currentItem();
-    if (currentItem) {
-        int id = currentItem->data(Qt::UserRole).toInt();
-        if (knowledgePoints.contains(id)) {
-            displayImage(knowledgePoints[id].imagePath);
-        }
+    int id = currentPointId();
+    if (m_pointStore->contains(id)) {
+        displayImage(m_pointStore->point(id).imagePath);
     }
 }
 //图片储存
@@ -1045,6 +1169,7 @@ QString MainWindow::copyImageToStorage(const QString &sourceImagePath)
     // 复制文件
     if (QFile::copy(sourceImagePath, targetFilePath)) {
         qDebug() << "Image copied to:" << targetFilePath;
+        m_imagePool->start(new ImageThumbnailTask(m_thumbnails, targetFilePath)); // 详情区以后只读缩略图
         return targetFilePath;
     } else {
         qDebug() << "Failed to copy image from" << sourceImagePath << "to" << targetFilePath;
@@ -1067,13 +1192,12 @@ bool MainWindow::eventFilter(QObject *watched, QEvent *event)
 }
 void MainWindow::handleImageClicked()
 {
-    QListWidgetItem *currentItem = ui->listKnowledgePoints->currentItem();
-    if (!currentItem) return;
+    int id = currentPointId();
+    if (id < 0) return;
 
-    int id = currentItem->data(Qt::UserRole).toInt();
-    if (!knowledgePoints.contains(id)) return;
+    if (!m_pointStore->contains(id)) return;
 
-    const KnowledgePoint &point = knowledgePoints[id];
+    const KnowledgePoint point = m_pointStore->point(id);
 
     // 优先使用文件路径
     if (!point.imagePath.isEmpty() && QFile::exists(point.imagePath)) {
@@ -1094,8 +1218,7 @@ void MainWindow::handleImageClicked()
 
 void MainWindow::on_familiarButton_clicked()
 {
-    QListWidgetItem *currentItem = ui->listKnowledgePoints->currentItem();
-    int id = currentItem->data(Qt::UserRole).toInt();
+    int id = currentPointId();
     int reviewvalue=10;
     markAsReviewed(id,reviewvalue);
 }
@@ -1103,8 +1226,7 @@ void MainWindow::on_familiarButton_clicked()
 
 void MainWindow::on_indistinctButton_clicked()
 {
-    QListWidgetItem *currentItem = ui->listKnowledgePoints->currentItem();
-    int id = currentItem->data(Qt::UserRole).toInt();
+    int id = currentPointId();
     int reviewvalue=-5;
     markAsReviewed(id,reviewvalue);
 }
@@ -1112,8 +1234,7 @@ void MainWindow::on_indistinctButton_clicked()
 
 void MainWindow::on_forgetButton_clicked()
 {
-    QListWidgetItem *currentItem = ui->listKnowledgePoints->currentItem();
-    int id = currentItem->data(Qt::UserRole).toInt();
+    int id = currentPointId();
     int reviewvalue=-10;
     markAsReviewed(id,reviewvalue);
 }
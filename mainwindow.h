@@ -2,7 +2,7 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
-#include <QListWidgetItem>
+#include <QModelIndex>
 #include <QDate>
 #include <QMap>
 #include <QDir>
@@ -11,6 +11,12 @@
 #include <QDateTime>
 #include <QMouseEvent>
 #include <QDialog>
+#include <QPointer>
+#include <QThread>
+#include <atomic>
+#include "knowledgepoint.h"
+#include "imagethumbnails.h"
+#include "imagecache.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -18,32 +24,12 @@ class MainWindow;
 }
 QT_END_NAMESPACE
 
-// 知识点状态枚举
-enum KnowledgeStatus {
-    STATUS_NEW,         // 新知识点
-    STATUS_LEARNING,    // 学习中
-    STATUS_REVIEWING,   // 复习中
-    STATUS_MASTERED     // 已掌握
-};
-
-// 知识点数据结构
-struct KnowledgePoint {
-    int id;
-    QString title;
-    QString content;
-    QString imagePath;
-    QString category;
-    KnowledgeStatus status;
-    int masteryLevel; // 掌握程度 0-100
-    QDate createDate;
-    QDate lastReviewDate;
-    QDate nextReviewDate;
-    int reviewCount;
-    int reviewtureCount;
-};
-
 // 前向声明
 class ImageViewerDialog;
+class KnowledgePointStore;
+class KnowledgeListModel;
+class KnowledgeCategoryModel;
+class QThreadPool;
 
 class MainWindow : public QMainWindow
 {
@@ -62,16 +48,19 @@ private slots:
     void handleMarkReviewed();
     void handleDeletePoint();
     void handleExportData();
+    void handleImportData();
     void handleClearSearch();
 
     // 其他交互槽函数
     void handleListSelectionChanged();
-    void handleListItemDoubleClicked(QListWidgetItem *item);
+    void handleListItemDoubleClicked(const QModelIndex &index);
     void handleSearchTextChanged(const QString &text);
     void handleFilterCategoryChanged(int index);
     void handleFilterStatusChanged(int index);
     void handleStatusChanged(int index);
     void handleCalendarClicked(const QDate &date);
+    void paintCalendarMonth(int year, int month);
+    void paintCalendarDay(const QDate &date);
 
     // 图片操作槽函数
     void handleZoomIn();
@@ -88,22 +77,41 @@ private slots:
 
 private:
     Ui::MainWindow *ui;
-    QMap<int, KnowledgePoint> knowledgePoints;
-    int nextId = 1;
+    KnowledgePointStore *m_pointStore; // 知识点存储（按ID增量保存）
+    KnowledgeListModel *m_listModel;   // 列表视图的模型
+    KnowledgeCategoryModel *m_categoryModel; // 分类过滤器的模型
     double imageZoomFactor = 1.0; // 图片缩放因子
 
     QString m_imageStoragePath; // 图片存储路径
+    ImageThumbnails m_thumbnails; // 存储目录里原图的缩略图
+    ImageCache m_imageCache;      // 详情区解码后的图片；查看器的原图另有缓存
 
     bool m_isRefreshing = false;// 防止刷新递归
 
+    // 列表过滤在后台线程进行：每次请求加一，旧任务看到新代数后放弃
+    QThreadPool *m_filterPool;
+    std::atomic<int> m_filterGeneration{0};
+    int m_listedGeneration = 0; // 列表当前显示的过滤结果的代数
+
+    // 详情区图片在后台解码：选中变化时加一，过期的结果直接丢弃
+    QThreadPool *m_imagePool;
+    std::atomic<int> m_imageGeneration{0};
+    QString m_displayedImagePath; // 标签上已显示的图片，只是重新缩放时保留到新图解码完成
+
     // 记忆曲线间隔（天数）
     const QVector<int> reviewIntervals = {1, 2, 4, 7, 15, 30, 60, 90};
 
     void loadKnowledgePoints();
     void saveKnowledgePoints();
-    void refreshKnowledgeList();
+    void refreshKnowledgeList(); // 提交后台过滤，结果由 applyFilterResult 一次换入
+    void applyFilterResult(int generation, const QVector<int> &ids);
+    int currentPointId() const; // 列表当前行的知识点ID，没有选中时返回 -1
     void updateStatistics();
     void showKnowledgePointDetails(int id);
+    void showKnowledgePointDetails(const KnowledgePoint &point, KnowledgePointFields fields);
+    void handlePointChanged(int id, KnowledgePointFields fields);
+    bool matchesFilter(const KnowledgePoint &point) const;
+    void highlightSearchMatches(); // 在内容区标出当前搜索词
     void addKnowledgePoint(const QString &title, const QString &content,
                            const QString &imagePath, const QString &category);
     void editKnowledgePoint(int id, const QString &title, const QString &content,
@@ -112,7 +120,8 @@ private:
     QDate calculateNextReviewDate(int currentLevel, int reviewCount);
     void updateMasteryLevel(int id, int newLevel);
     void filterKnowledgePoints();
-    void displayImage(const QString &imagePath); // 显示图片函数
+    void setEditingEnabled(bool enabled); // 导入期间禁用增删改
+    void displayImage(const QString &imagePath); // 显示图片函数，解码在后台进行
 
     // 当前过滤条件
     QString currentSearchText;
@@ -126,6 +135,9 @@ private:
 
     ImageViewerDialog *m_imageViewer; // 图片查看对话框
 
+    QPointer<QThread> m_exportThread; // 正在运行的导出线程
+    QPointer<QThread> m_importThread; // 正在运行的导入线程
+
     // void debugDataSources();//看资源在哪的，可删
 
 protected:
@@ -0,0 +1,174 @@
+#include "persistenceworker.h"
+#include "knowledgedatabasemanager.h"
+#include <QTimer>
+#include <QDebug>
+#include <utility>
+
+// 普通修改在这个窗口内合并为一次提交
+static const int kDebounceMs = 250;
+// 复习已写入日志，不急于提交：最后一次复习后等待一段时间，或积累到一定条数
+static const int kCompactDelayMs = 60 * 1000;
+static const int kCompactThreshold = 256;
+// 提交失败后的重试间隔
+static const int kRetryDelayMs = 5000;
+
+PersistenceWorker::PersistenceWorker(const QString &databasePath, const QString &journalPath,
+                                     QObject *parent)
+    : QObject(parent)
+    , m_databasePath(databasePath)
+    , m_journalPath(journalPath)
+    , m_debounceTimer(new QTimer(this))
+    , m_compactTimer(new QTimer(this))
+{
+    m_debounceTimer->setSingleShot(true);
+    connect(m_debounceTimer, &QTimer::timeout, this, &PersistenceWorker::commit);
+
+    m_compactTimer->setSingleShot(true);
+    m_compactTimer->setInterval(kCompactDelayMs);
+    connect(m_compactTimer, &QTimer::timeout, this, &PersistenceWorker::commit);
+}
+
+void PersistenceWorker::open()
+{
+    // 数据库连接必须在使用它的线程中创建
+    m_database = new KnowledgeDatabaseManager(this, "knowledge_writer");
+    if (!m_database->initializeDatabase(m_databasePath)) {
+        emit writeFailed("无法打开数据库");
+    }
+
+    m_journal.open(m_journalPath);
+}
+
+void PersistenceWorker::enqueue(const QVector<KnowledgePoint> &upserts, const QVector<KnowledgePoint> &metadataUpdates,
+                                const QVector<int> &removals)
+{
+    for (const KnowledgePoint &point : upserts) {
+        m_pendingUpserts.insert(point.id, point);
+        m_pendingMetadata.remove(point.id);
+        m_pendingReviews.remove(point.id);
+    }
+    for (const KnowledgePoint &point : metadataUpdates) {
+        queueMetadata(point);
+    }
+    for (int id : removals) {
+        m_pendingUpserts.remove(id);
+        m_pendingMetadata.remove(id);
+        m_pendingReviews.remove(id);
+        m_pendingRemovals.insert(id);
+    }
+
+    m_debounceTimer->start(kDebounceMs);
+}
+
+void PersistenceWorker::recordReview(const ReviewEvent &event, const KnowledgePoint &point)
+{
+    queueReview(point);
+
+    // 日志写入失败时尽快提交，保证复习不丢失
+    if (!m_journal.append(event) || m_journal.pendingCount() >= kCompactThreshold) {
+        m_debounceTimer->start(kDebounceMs);
+    } else if (!m_debounceTimer->isActive()) {
+        m_compactTimer->start();
+    }
+}
+
+void PersistenceWorker::queueMetadata(const KnowledgePoint &point)
+{
+    // 已有整行写入时并入其中，保留那次写入的内容
+    auto pending = m_pendingUpserts.find(point.id);
+    if (pending != m_pendingUpserts.end()) {
+        const QString content = pending->content;
+        const QString imagePath = pending->imagePath;
+        *pending = point;
+        pending->content = content;
+        pending->imagePath = imagePath;
+    } else {
+        m_pendingMetadata.insert(point.id, point);
+    }
+    m_pendingReviews.remove(point.id);
+}
+
+void PersistenceWorker::queueReview(const KnowledgePoint &point)
+{
+    // 同一知识点已有更大范围的写入时并入其中，否则只写排程列
+    if (m_pendingUpserts.contains(point.id) || m_pendingMetadata.contains(point.id)) {
+        queueMetadata(point);
+    } else {
+        m_pendingReviews.insert(point.id, point);
+    }
+}
+
+qint64 PersistenceWorker::flush()
+{
+    if (!commit()) {
+        return -1;
+    }
+    return m_database->generation();
+}
+
+bool PersistenceWorker::commit()
+{
+    m_debounceTimer->stop();
+    m_compactTimer->stop();
+
+    if (!m_database || !m_database->isConnected()) {
+        return false;
+    }
+
+    if (m_pendingUpserts.isEmpty() && m_pendingMetadata.isEmpty() && m_pendingReviews.isEmpty()
+        && m_pendingRemovals.isEmpty()) {
+        // 日志里只剩已删除知识点的记录
+        m_journal.reset();
+        return true;
+    }
+
+    // 提交后会清空复习日志，这次提交必须先落盘：NORMAL 同步级别下
+    // 断电可能丢掉刚提交的事务，而日志已经清空，复习就丢了
+    const bool durable = m_journal.pendingCount() > 0;
+    bool ok = !durable || m_database->setFullSync(true);
+    ok = ok && m_database->beginTransaction();
+    if (ok) {
+        for (int id : std::as_const(m_pendingRemovals)) {
+            ok = ok && m_database->deletePoint(id);
+        }
+        for (const KnowledgePoint &point : std::as_const(m_pendingUpserts)) {
+            ok = ok && m_database->savePoint(point);
+        }
+        for (const KnowledgePoint &point : std::as_const(m_pendingMetadata)) {
+            ok = ok && m_database->savePointMetadata(point);
+        }
+        for (const KnowledgePoint &point : std::as_const(m_pendingReviews)) {
+            ok = ok && m_database->saveReviewState(point);
+        }
+        if (!ok) {
+            m_database->rollbackTransaction();
+        }
+    }
+
+    ok = ok && m_database->commitTransaction();
+    if (durable) {
+        m_database->setFullSync(false);
+    }
+
+    if (!ok) {
+        // 保留待写数据，稍后重试
+        qDebug() << "Persistence commit failed, retrying in" << kRetryDelayMs << "ms";
+        m_debounceTimer->start(kRetryDelayMs);
+        emit writeFailed("保存数据失败，稍后重试");
+        return false;
+    }
+
+    qDebug() << "Committed" << m_pendingUpserts.size() + m_pendingMetadata.size() + m_pendingReviews.size()
+             << "changed and" << m_pendingRemovals.size() << "removed knowledge points";
+
+    m_pendingUpserts.clear();
+    m_pendingMetadata.clear();
+    m_pendingReviews.clear();
+    m_pendingRemovals.clear();
+
+    // 日志中的复习都已随本次事务提交
+    m_journal.reset();
+
+    emit committed(m_database->generation());
+    return true;
+}
@@ -0,0 +1,56 @@
+#ifndef PERSISTENCEWORKER_H
+#define PERSISTENCEWORKER_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include "knowledgepoint.h"
+#include "reviewjournal.h"
+
+class QTimer;
+class KnowledgeDatabaseManager;
+
+// 持久化工作线程：接收界面线程发来的改动，在短时间窗口内合并，
+// 然后用一个事务写入数据库。复习事件先追加到复习日志再参与合并。
+// 对象通过 moveToThread() 放到专用线程，下面的公有函数都在该线程中调用
+class PersistenceWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    PersistenceWorker(const QString &databasePath, const QString &journalPath,
+                      QObject *parent = nullptr);
+
+    void open();
+    // upserts 写入整行；metadataUpdates 的内容不在内存中，只写元数据列
+    void enqueue(const QVector<KnowledgePoint> &upserts, const QVector<KnowledgePoint> &metadataUpdates,
+                 const QVector<int> &removals);
+    void recordReview(const ReviewEvent &event, const KnowledgePoint &point);
+    qint64 flush(); // 写入屏障：立即提交全部待写数据，返回数据代数，失败返回 -1
+
+signals:
+    void committed(qint64 generation);
+    void writeFailed(const QString &errorMessage);
+
+private:
+    QString m_databasePath;
+    QString m_journalPath;
+    KnowledgeDatabaseManager *m_database = nullptr;
+    ReviewJournal m_journal;
+
+    // 合并后的待写数据：同一知识点只保留最新版本
+    QHash<int, KnowledgePoint> m_pendingUpserts;
+    QHash<int, KnowledgePoint> m_pendingMetadata; // 不含内容，不能整行写入
+    QHash<int, KnowledgePoint> m_pendingReviews;  // 只有复习排程变化
+    QSet<int> m_pendingRemovals;
+
+    QTimer *m_debounceTimer; // 普通修改：短合并窗口
+    QTimer *m_compactTimer;  // 只有复习日志时：较长的合并间隔
+
+    void queueMetadata(const KnowledgePoint &point);
+    void queueReview(const KnowledgePoint &point);
+    bool commit();
+};
+
+#endif // PERSISTENCEWORKER_H
@@ -0,0 +1,161 @@
+#include "reviewjournal.h"
+#include <QDebug>
+#include <cstring>
+#include <cstddef>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+static const quint32 kRecordMagic = 0x4B524A31; // "KRJ1"
+
+struct JournalRecord {
+    quint32 magic;
+    qint32 pointId;
+    qint64 timestamp;
+    qint32 grade;
+    qint32 interval;
+    qint32 status;
+    qint32 masteryLevel;
+    qint32 reviewCount;
+    qint32 reserved;
+    qint64 lastReviewDay;  // 儒略日，0 表示无效日期
+    qint64 nextReviewDay;
+    quint64 checksum;      // 对前面所有字段做 FNV-1a
+};
+
+static_assert(sizeof(JournalRecord) == 64, "unexpected journal record layout");
+
+static quint64 recordChecksum(const JournalRecord &record)
+{
+    const char *data = reinterpret_cast<const char *>(&record);
+    quint64 hash = 1469598103934665603ULL;
+    for (size_t i = 0; i < offsetof(JournalRecord, checksum); ++i) {
+        hash ^= static_cast<quint8>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// 先刷新 Qt 缓冲，再把数据落盘
+static bool syncFile(QFile &file)
+{
+    if (!file.flush()) {
+        return false;
+    }
+#ifdef Q_OS_WIN
+    return _commit(file.handle()) == 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
+
+ReviewJournal::ReviewJournal()
+{
+}
+
+ReviewJournal::~ReviewJournal()
+{
+    m_file.close();
+}
+
+bool ReviewJournal::open(const QString &path)
+{
+    m_file.close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite | QIODevice::Append)) {
+        qDebug() << "Cannot open review journal:" << path << m_file.errorString();
+        return false;
+    }
+
+    m_pendingCount = int(m_file.size() / qint64(sizeof(JournalRecord)));
+    return true;
+}
+
+bool ReviewJournal::append(const ReviewEvent &event)
+{
+    if (!m_file.isOpen()) {
+        return false;
+    }
+
+    JournalRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.magic = kRecordMagic;
+    record.pointId = event.pointId;
+    record.timestamp = event.timestamp;
+    record.grade = event.grade;
+    record.interval = event.interval;
+    record.status = static_cast<qint32>(event.status);
+    record.masteryLevel = event.masteryLevel;
+    record.reviewCount = event.reviewCount;
+    record.lastReviewDay = event.lastReviewDate.isValid() ? event.lastReviewDate.toJulianDay() : 0;
+    record.nextReviewDay = event.nextReviewDate.isValid() ? event.nextReviewDate.toJulianDay() : 0;
+    record.checksum = recordChecksum(record);
+
+    if (m_file.write(reinterpret_cast<const char *>(&record), sizeof(record)) != qint64(sizeof(record))
+        || !syncFile(m_file)) {
+        qDebug() << "Failed to append review journal:" << m_file.errorString();
+        return false;
+    }
+
+    ++m_pendingCount;
+    return true;
+}
+
+QVector<ReviewEvent> ReviewJournal::readAll(const QString &path)
+{
+    QVector<ReviewEvent> events;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return events;
+    }
+
+    JournalRecord record;
+    while (file.read(reinterpret_cast<char *>(&record), sizeof(record)) == qint64(sizeof(record))) {
+        if (record.magic != kRecordMagic || record.checksum != recordChecksum(record)) {
+            qDebug() << "Review journal tail is damaged, ignoring remaining records";
+            break;
+        }
+
+        ReviewEvent event;
+        event.pointId = record.pointId;
+        event.timestamp = record.timestamp;
+        event.grade = record.grade;
+        event.interval = record.interval;
+        event.status = static_cast<KnowledgeStatus>(record.status);
+        event.masteryLevel = record.masteryLevel;
+        event.reviewCount = record.reviewCount;
+        event.lastReviewDate = record.lastReviewDay ? QDate::fromJulianDay(record.lastReviewDay) : QDate();
+        event.nextReviewDate = record.nextReviewDay ? QDate::fromJulianDay(record.nextReviewDay) : QDate();
+        events.append(event);
+    }
+
+    return events;
+}
+
+bool ReviewJournal::reset()
+{
+    if (!m_file.isOpen()) {
+        return false;
+    }
+
+    if (m_pendingCount == 0 && m_file.size() == 0) {
+        return true;
+    }
+
+    if (!m_file.resize(0) || !syncFile(m_file)) {
+        qDebug() << "Failed to reset review journal:" << m_file.errorString();
+        return false;
+    }
+
+    m_pendingCount = 0;
+    return true;
+}
+
+int ReviewJournal::pendingCount() const
+{
+    return m_pendingCount;
+}
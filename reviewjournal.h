@@ -0,0 +1,41 @@
+#ifndef REVIEWJOURNAL_H
+#define REVIEWJOURNAL_H
+
+#include <QFile>
+#include <QVector>
+#include "knowledgepoint.h"
+
+// 一次复习事件。除评分外还记录复习后的状态，
+// 重放时直接覆盖，重复重放结果不变
+struct ReviewEvent {
+    int pointId;
+    qint64 timestamp;   // 毫秒时间戳
+    int grade;          // 熟悉 10 / 模糊 -5 / 忘记 -10
+    int interval;       // 到下次复习的天数
+    KnowledgeStatus status;
+    int masteryLevel;
+    int reviewCount;
+    QDate lastReviewDate;
+    QDate nextReviewDate;
+};
+
+// 只追加的复习日志：每次复习写入一条定长记录并 fsync，
+// 合并进数据库后清空。每条记录带校验和，断电留下的半条记录在重放时丢弃
+class ReviewJournal
+{
+public:
+    ReviewJournal();
+    ~ReviewJournal();
+
+    bool open(const QString &path);
+    bool append(const ReviewEvent &event);
+    static QVector<ReviewEvent> readAll(const QString &path);
+    bool reset(); // 内容已合并进数据库后清空
+    int pendingCount() const;
+
+private:
+    QFile m_file;
+    int m_pendingCount = 0;
+};
+
+#endif // REVIEWJOURNAL_H
@@ -0,0 +1,250 @@
+#include "tiledimageview.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QScrollBar>
+#include <QWheelEvent>
+#include <QMouseEvent>
+#include <QtMath>
+#include <cmath>
+
+static const int kTileSize = 256;
+static const int kTileCacheKB = 64 * 1024; // 图块缓存上限 64 MB
+static const double kMinScale = 0.01;
+static const double kMaxScale = 32.0;
+static const double kWheelZoomStep = 1.25;
+
+static inline quint64 tileKey(int levelIndex, int column, int row)
+{
+    return (quint64(levelIndex) << 48) | (quint64(row) << 24) | quint64(column);
+}
+
+TiledImageView::TiledImageView(QWidget *parent)
+    : QAbstractScrollArea(parent)
+{
+    m_tiles.setMaxCost(kTileCacheKB);
+    viewport()->setBackgroundRole(QPalette::Dark);
+    horizontalScrollBar()->setSingleStep(20);
+    verticalScrollBar()->setSingleStep(20);
+}
+
+void TiledImageView::setImage(const QImage &image)
+{
+    m_levels.clear();
+    m_tiles.clear();
+
+    if (!image.isNull()) {
+        // 统一成绘制最快的格式，已经是的话不复制
+        const QImage::Format format = image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                              : QImage::Format_RGB32;
+        m_levels.append(image.format() == format ? image : image.convertToFormat(format));
+    }
+
+    m_scale = 1.0;
+    updateScrollBars();
+    horizontalScrollBar()->setValue(0);
+    verticalScrollBar()->setValue(0);
+    viewport()->update();
+}
+
+void TiledImageView::setScale(double scale)
+{
+    setScale(scale, QPointF(viewport()->width() / 2.0, viewport()->height() / 2.0));
+}
+
+void TiledImageView::setScale(double scale, const QPointF &anchor)
+{
+    scale = qBound(kMinScale, scale, kMaxScale);
+    if (m_levels.isEmpty() || qFuzzyCompare(scale, m_scale)) {
+        return;
+    }
+
+    // 锚点下的原图坐标，缩放后把它移回锚点
+    const QPointF imagePoint = (anchor - imageOrigin()) / m_scale;
+    m_scale = scale;
+    updateScrollBars();
+    horizontalScrollBar()->setValue(qRound(imagePoint.x() * m_scale - anchor.x()));
+    verticalScrollBar()->setValue(qRound(imagePoint.y() * m_scale - anchor.y()));
+    viewport()->update();
+}
+
+double TiledImageView::fitScale() const
+{
+    const QSize size = imageSize();
+    if (size.isEmpty()) {
+        return 1.0;
+    }
+    return qMin(double(viewport()->width()) / size.width(),
+                double(viewport()->height()) / size.height());
+}
+
+int TiledImageView::levelFor(double scale) const
+{
+    // 第 k 层的比例 2^-k 不小于 scale：缩小绘制，不会放大低分辨率的层
+    int index = scale < 1.0 ? int(qFloor(std::log2(1.0 / scale))) : 0;
+    const QSize size = imageSize();
+    while (index > 0 && qMax(size.width(), size.height()) >> index < kTileSize) {
+        --index; // 比一个图块还小的层没有意义
+    }
+    return index;
+}
+
+const QImage &TiledImageView::level(int index)
+{
+    // 逐层从上一层缩小一半，第一次用到时才建立
+    while (m_levels.size() <= index) {
+        const QImage &previous = m_levels.last();
+        m_levels.append(previous.scaled((previous.width() + 1) / 2, (previous.height() + 1) / 2,
+                                        Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+    }
+    return m_levels.at(index);
+}
+
+QPixmap TiledImageView::tile(int levelIndex, int column, int row)
+{
+    const quint64 key = tileKey(levelIndex, column, row);
+    if (const QPixmap *cached = m_tiles.object(key)) {
+        return *cached;
+    }
+
+    const QImage &image = level(levelIndex);
+    const QRect rect = QRect(column * kTileSize, row * kTileSize, kTileSize, kTileSize)
+                           .intersected(image.rect());
+    QPixmap *pixmap = new QPixmap(QPixmap::fromImage(image.copy(rect)));
+    const QPixmap result = *pixmap;
+    m_tiles.insert(key, pixmap, qMax(1, int(qint64(rect.width()) * rect.height() * 4 / 1024)));
+    return result;
+}
+
+QPointF TiledImageView::imageOrigin() const
+{
+    // 图片比视口小时居中，否则由滚动条决定
+    const QSizeF content = QSizeF(imageSize()) * m_scale;
+    const double x = content.width() < viewport()->width()
+                         ? (viewport()->width() - content.width()) / 2.0
+                         : -horizontalScrollBar()->value();
+    const double y = content.height() < viewport()->height()
+                         ? (viewport()->height() - content.height()) / 2.0
+                         : -verticalScrollBar()->value();
+    return QPointF(x, y);
+}
+
+void TiledImageView::updateScrollBars()
+{
+    const QSize content = (QSizeF(imageSize()) * m_scale).toSize();
+    const QSize view = viewport()->size();
+    horizontalScrollBar()->setPageStep(view.width());
+    verticalScrollBar()->setPageStep(view.height());
+    horizontalScrollBar()->setRange(0, qMax(0, content.width() - view.width()));
+    verticalScrollBar()->setRange(0, qMax(0, content.height() - view.height()));
+}
+
+void TiledImageView::paintEvent(QPaintEvent *event)
+{
+    if (m_levels.isEmpty()) {
+        return;
+    }
+
+    const int levelIndex = levelFor(m_scale);
+    const QImage &image = level(levelIndex);
+    const double levelScale = m_scale * imageSize().width() / image.width(); // 该层像素 -> 视口像素
+    const QPointF origin = imageOrigin();
+
+    // 可见区域换算到该层的像素坐标
+    const QRectF visible = QRectF(QPointF(event->rect().topLeft()) - origin,
+                                  QSizeF(event->rect().size())).intersected(
+        QRectF(QPointF(0, 0), QSizeF(image.size()) * levelScale));
+    if (visible.isEmpty()) {
+        return;
+    }
+
+    const int firstColumn = int(visible.left() / levelScale) / kTileSize;
+    const int lastColumn = qMax(firstColumn, int((visible.right() - 1) / levelScale) / kTileSize);
+    const int firstRow = int(visible.top() / levelScale) / kTileSize;
+    const int lastRow = qMax(firstRow, int((visible.bottom() - 1) / levelScale) / kTileSize);
+
+    // 图块边缘各自取整到视口像素，相邻图块共用同一条边，不会出现缝隙
+    const auto edgeX = [&](int pixel) { return qRound(origin.x() + qMin(pixel, image.width()) * levelScale); };
+    const auto edgeY = [&](int pixel) { return qRound(origin.y() + qMin(pixel, image.height()) * levelScale); };
+
+    QPainter painter(viewport());
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            const int left = edgeX(column * kTileSize);
+            const int top = edgeY(row * kTileSize);
+            const QRect target(left, top,
+                               edgeX((column + 1) * kTileSize) - left,
+                               edgeY((row + 1) * kTileSize) - top);
+            painter.drawPixmap(target, tile(levelIndex, column, row));
+        }
+    }
+}
+
+void TiledImageView::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBars();
+}
+
+void TiledImageView::scrollContentsBy(int dx, int dy)
+{
+    Q_UNUSED(dx);
+    Q_UNUSED(dy);
+    viewport()->update();
+}
+
+void TiledImageView::wheelEvent(QWheelEvent *event)
+{
+    // Ctrl + 滚轮以光标为中心缩放，否则照常滚动
+    if (!(event->modifiers() & Qt::ControlModifier)) {
+        QAbstractScrollArea::wheelEvent(event);
+        return;
+    }
+
+    const double factor = event->angleDelta().y() > 0 ? kWheelZoomStep : 1.0 / kWheelZoomStep;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    const QPointF anchor = event->position();
+#else
+    const QPointF anchor = event->posF();
+#endif
+    setScale(m_scale * factor, anchor);
+    event->accept();
+}
+
+void TiledImageView::mousePressEvent(QMouseEvent *event)
+{
+    // 左键拖动平移；其他按键交给对话框（右键重置缩放）
+    if (event->button() == Qt::LeftButton) {
+        m_dragging = true;
+        m_lastDragPos = event->pos();
+        viewport()->setCursor(Qt::ClosedHandCursor);
+        event->accept();
+    } else {
+        QAbstractScrollArea::mousePressEvent(event);
+    }
+}
+
+void TiledImageView::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!m_dragging) {
+        QAbstractScrollArea::mouseMoveEvent(event);
+        return;
+    }
+
+    const QPoint delta = event->pos() - m_lastDragPos;
+    m_lastDragPos = event->pos();
+    horizontalScrollBar()->setValue(horizontalScrollBar()->value() - delta.x());
+    verticalScrollBar()->setValue(verticalScrollBar()->value() - delta.y());
+    event->accept();
+}
+
+void TiledImageView::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (m_dragging && event->button() == Qt::LeftButton) {
+        m_dragging = false;
+        viewport()->unsetCursor();
+        event->accept();
+    } else {
+        QAbstractScrollArea::mouseReleaseEvent(event);
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef TILEDIMAGEVIEW_H
+#define TILEDIMAGEVIEW_H
+
+#include <QAbstractScrollArea>
+#include <QCache>
+#include <QImage>
+#include <QPixmap>
+#include <QVector>
+
+// 大图查看：按需建立图片金字塔（第 k 层是原图缩小 2^k 倍），
+// 每层切成 256×256 的图块，只绘制视口里可见的图块。
+// 选用不小于当前缩放比例的最小一层，图块在绘制时再缩放到屏幕尺寸，
+// 所以缩放和平移的开销只与视口大小有关，与原图大小无关
+class TiledImageView : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    explicit TiledImageView(QWidget *parent = nullptr);
+
+    void setImage(const QImage &image);
+    QSize imageSize() const { return m_levels.isEmpty() ? QSize() : m_levels.first().size(); }
+
+    double scale() const { return m_scale; }
+    void setScale(double scale); // 以视口中心为锚点
+    void setScale(double scale, const QPointF &anchor); // anchor 为视口坐标，缩放前后位于它下面的像素不动
+    double fitScale() const; // 整张图片放进视口的比例
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+
+private:
+    QVector<QImage> m_levels;          // 已建立的金字塔层，第 0 层是原图
+    QCache<quint64, QPixmap> m_tiles;  // (层, 行, 列) -> 图块，开销以 KB 计
+    double m_scale = 1.0;
+    bool m_dragging = false;
+    QPoint m_lastDragPos;
+
+    int levelFor(double scale) const;
+    const QImage &level(int index);
+    QPixmap tile(int levelIndex, int column, int row);
+    QPointF imageOrigin() const; // 原图左上角在视口中的位置
+    void updateScrollBars();
+};
+
+#endif // TILEDIMAGEVIEW_H